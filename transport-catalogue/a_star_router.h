@@ -0,0 +1,101 @@
+#pragma once
+
+#include "graph.h"
+#include "route_builder.h"
+#include "dijkstra_router.h"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Goal-directed Dijkstra. heuristic(vertex, to) must never overestimate the weight
+// of the lightest route from vertex to "to"; the more it tells, the fewer vertices are settled.
+template <typename Weight>
+class AStarRouter final : public RouteBuilder<Weight> {
+
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename RouteBuilder<Weight>::RouteInfo;
+    using Heuristic = std::function<Weight(VertexId, VertexId)>;
+
+    explicit AStarRouter(const Graph& graph, Heuristic heuristic);
+
+    using RouteBuilder<Weight>::BuildRoute;
+    std::optional<Weight> BuildRoute(VertexId from, VertexId to, std::vector<EdgeId>& edges) const override;
+
+private:
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr EdgeId NO_EDGE = SearchSpace<Weight>::NO_EDGE;
+
+    const Graph& graph_;
+    Heuristic heuristic_;
+};
+
+template <typename Weight>
+AStarRouter<Weight>::AStarRouter(const Graph& graph, Heuristic heuristic)
+    : graph_(graph)
+    , heuristic_(std::move(heuristic))
+{
+    if (!graph.IsFrozen()) {
+        throw std::logic_error("Graph should be frozen before a search");
+    }
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+}
+
+template <typename Weight>
+std::optional<Weight> AStarRouter<Weight>::BuildRoute(VertexId from, VertexId to, std::vector<EdgeId>& edges) const {
+    static thread_local SearchSpace<Weight> search_space;
+    search_space.Prepare(graph_.GetVertexCount());
+    search_space.Reach(from, ZERO_WEIGHT, NO_EDGE, heuristic_(from, to));
+
+    // A vertex whose weight improves after it was settled is simply settled again,
+    // so the route stays the lightest one even if the heuristic is not consistent.
+    const auto& arc_offsets = graph_.GetArcOffsets();
+    const auto& arc_edges = graph_.GetArcEdges();
+    const auto& arc_targets = graph_.GetArcTargets();
+    const auto& arc_weights = graph_.GetArcWeights();
+
+    VertexId vertex;
+    while (search_space.PopNearest(vertex)) {
+        if (vertex == to) {
+            break;
+        }
+        const Weight distance = search_space.distances[vertex];
+        for (size_t arc = arc_offsets[vertex]; arc < arc_offsets[vertex + 1]; ++arc) {
+            const VertexId next = arc_targets[arc];
+            const Weight candidate_weight = distance + arc_weights[arc];
+            if (candidate_weight < search_space.distances[next]) {
+                search_space.Reach(next, candidate_weight, arc_edges[arc], candidate_weight + heuristic_(next, to));
+            }
+        }
+    }
+
+    std::optional<Weight> output;
+    edges.clear();
+    if (search_space.IsReached(to)) {
+        for (EdgeId edge_id = search_space.prev_edges[to];
+             edge_id != NO_EDGE;
+             edge_id = search_space.prev_edges[graph_.GetEdge(edge_id).from])
+        {
+            edges.push_back(edge_id);
+        }
+        std::reverse(edges.begin(), edges.end());
+        output = search_space.distances[to];
+    }
+    search_space.Reset();
+
+    return output;
+}
+
+}  // namespace graph
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace arena {
+
+// Append-only storage of objects in contiguous chunks. A chunk never grows past the capacity
+// it was allocated with, so the addresses of the objects stay valid until the arena is destroyed.
+template <typename T>
+class ChunkedArena {
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 256;
+
+    explicit ChunkedArena(size_t chunk_size = DEFAULT_CHUNK_SIZE)
+        : chunk_size_(std::max<size_t>(chunk_size, 1)) {
+    }
+
+    // Copies would point into the storage of the original.
+    ChunkedArena(const ChunkedArena&) = delete;
+    ChunkedArena& operator=(const ChunkedArena&) = delete;
+    ChunkedArena(ChunkedArena&&) = default;
+    ChunkedArena& operator=(ChunkedArena&&) = default;
+
+    template <typename... Args>
+    T& Emplace(Args&&... args) {
+        if (chunks_.empty() || chunks_.back().size() == chunks_.back().capacity()) {
+            AddChunk(chunk_size_);
+        }
+        ++size_;
+        return chunks_.back().emplace_back(std::forward<Args>(args)...);
+    }
+
+    // Makes room for count more objects in one chunk, so a bulk load takes a single allocation.
+    void Reserve(size_t count) {
+        if (!chunks_.empty() && chunks_.back().capacity() - chunks_.back().size() >= count) {
+            return;
+        }
+        AddChunk(std::max(count, chunk_size_));
+    }
+
+    size_t size() const {
+        return size_;
+    }
+    bool empty() const {
+        return size_ == 0;
+    }
+
+private:
+    void AddChunk(size_t capacity) {
+        // An empty last chunk is replaced rather than left as a hole.
+        if (chunks_.empty() || !chunks_.back().empty()) {
+            chunks_.emplace_back();
+        }
+        chunks_.back().reserve(capacity);
+    }
+
+    size_t chunk_size_;
+    size_t size_ = 0;
+    std::vector<std::vector<T>> chunks_;
+};
+
+// Keeps one copy of every distinct string; the views it hands out stay valid until the pool is destroyed.
+class StringPool {
+public:
+    std::string_view Intern(std::string_view text) {
+        if (const auto it = index_.find(text); it != index_.end()) {
+            return *it;
+        }
+        return *index_.insert(strings_.Emplace(text)).first;
+    }
+
+    void Reserve(size_t count) {
+        strings_.Reserve(count);
+        index_.reserve(index_.size() + count);
+    }
+
+    size_t size() const {
+        return strings_.size();
+    }
+
+private:
+    ChunkedArena<std::string> strings_;
+    std::unordered_set<std::string_view> index_;
+};
+
+}  // namespace arena
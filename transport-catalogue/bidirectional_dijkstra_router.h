@@ -0,0 +1,143 @@
+#pragma once
+
+#include "graph.h"
+#include "route_builder.h"
+#include "dijkstra_router.h"
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Query-time router running Dijkstra from "from" over outgoing edges and from "to"
+// over incoming ones at the same time. The graph must be frozen to have incoming edges.
+template <typename Weight>
+class BidirectionalDijkstraRouter final : public RouteBuilder<Weight> {
+
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename RouteBuilder<Weight>::RouteInfo;
+
+    explicit BidirectionalDijkstraRouter(const Graph& graph);
+
+    using RouteBuilder<Weight>::BuildRoute;
+    std::optional<Weight> BuildRoute(VertexId from, VertexId to, std::vector<EdgeId>& edges) const override;
+
+private:
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr Weight INFINITE_WEIGHT = SearchSpace<Weight>::INFINITE_WEIGHT;
+    static constexpr EdgeId NO_EDGE = SearchSpace<Weight>::NO_EDGE;
+
+    // Settles the nearest vertex of "search" and relaxes its edges (outgoing ones if forward);
+    // every vertex reached by both searches is a candidate meeting point.
+    void Step(SearchSpace<Weight>& search, const SearchSpace<Weight>& opposite, bool forward,
+              Weight& best_weight, VertexId& meeting_vertex) const;
+
+    const Graph& graph_;
+};
+
+template <typename Weight>
+BidirectionalDijkstraRouter<Weight>::BidirectionalDijkstraRouter(const Graph& graph)
+    : graph_(graph)
+{
+    if (!graph.IsFrozen()) {
+        throw std::logic_error("Graph should be frozen before a search");
+    }
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+}
+
+template <typename Weight>
+void BidirectionalDijkstraRouter<Weight>::Step(SearchSpace<Weight>& search, const SearchSpace<Weight>& opposite,
+                                               bool forward, Weight& best_weight, VertexId& meeting_vertex) const {
+    VertexId vertex;
+    if (!search.PopNearest(vertex)) {
+        return;
+    }
+    const Weight distance = search.distances[vertex];
+    const auto relax = [&](VertexId next, Weight weight, EdgeId edge_id) {
+        const Weight candidate_weight = distance + weight;
+        if (candidate_weight < search.distances[next]) {
+            search.Reach(next, candidate_weight, edge_id);
+            if (opposite.IsReached(next) && candidate_weight + opposite.distances[next] < best_weight) {
+                best_weight = candidate_weight + opposite.distances[next];
+                meeting_vertex = next;
+            }
+        }
+    };
+
+    if (forward) {
+        const auto& arc_offsets = graph_.GetArcOffsets();
+        for (size_t arc = arc_offsets[vertex]; arc < arc_offsets[vertex + 1]; ++arc) {
+            relax(graph_.GetArcTargets()[arc], graph_.GetArcWeights()[arc], graph_.GetArcEdges()[arc]);
+        }
+    } else {
+        for (const EdgeId edge_id : graph_.GetIncomingEdges(vertex)) {
+            const auto& edge = graph_.GetEdge(edge_id);
+            relax(edge.from, edge.weight, edge_id);
+        }
+    }
+}
+
+template <typename Weight>
+std::optional<Weight> BidirectionalDijkstraRouter<Weight>::BuildRoute(VertexId from, VertexId to,
+                                                                      std::vector<EdgeId>& edges) const {
+    static thread_local SearchSpace<Weight> forward_search;
+    static thread_local SearchSpace<Weight> backward_search;
+    forward_search.Prepare(graph_.GetVertexCount());
+    backward_search.Prepare(graph_.GetVertexCount());
+    forward_search.Reach(from, ZERO_WEIGHT, NO_EDGE);
+    backward_search.Reach(to, ZERO_WEIGHT, NO_EDGE);
+
+    Weight best_weight = from == to ? ZERO_WEIGHT : INFINITE_WEIGHT;
+    VertexId meeting_vertex = from;
+
+    // Any route through a vertex not settled yet is at least as heavy as the sum of
+    // both minimal keys, so the search is over once that sum reaches the best route.
+    while (true) {
+        const Weight forward_key = forward_search.GetMinKey();
+        const Weight backward_key = backward_search.GetMinKey();
+        if (forward_key == INFINITE_WEIGHT || backward_key == INFINITE_WEIGHT
+            || forward_key + backward_key >= best_weight) {
+            break;
+        }
+        if (forward_key <= backward_key) {
+            Step(forward_search, backward_search, true, best_weight, meeting_vertex);
+        } else {
+            Step(backward_search, forward_search, false, best_weight, meeting_vertex);
+        }
+    }
+
+    std::optional<Weight> output;
+    edges.clear();
+    if (best_weight != INFINITE_WEIGHT) {
+        for (EdgeId edge_id = forward_search.prev_edges[meeting_vertex];
+             edge_id != NO_EDGE;
+             edge_id = forward_search.prev_edges[graph_.GetEdge(edge_id).from])
+        {
+            edges.push_back(edge_id);
+        }
+        std::reverse(edges.begin(), edges.end());
+        for (EdgeId edge_id = backward_search.prev_edges[meeting_vertex];
+             edge_id != NO_EDGE;
+             edge_id = backward_search.prev_edges[graph_.GetEdge(edge_id).to])
+        {
+            edges.push_back(edge_id);
+        }
+        output = best_weight;
+    }
+    forward_search.Reset();
+    backward_search.Reset();
+
+    return output;
+}
+
+}  // namespace graph
@@ -0,0 +1,402 @@
+#pragma once
+
+#include "graph.h"
+#include "route_builder.h"
+#include "dijkstra_router.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Contraction hierarchy over a DirectedWeightedGraph. Vertices are contracted one by one
+// in the order of their ranks; every contraction adds shortcuts that keep the distances
+// between the remaining vertices. A query is a bidirectional Dijkstra that only goes
+// up the hierarchy, the found shortcuts are unpacked back into the edges of the graph.
+//
+// Edge ids below graph.GetEdgeCount() are the graph edges, a shortcut has the id
+// graph.GetEdgeCount() + its index in GetShortcuts().
+template <typename Weight>
+class ContractionHierarchy final : public RouteBuilder<Weight> {
+
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename RouteBuilder<Weight>::RouteInfo;
+
+    struct Shortcut {
+        VertexId from;
+        VertexId to;
+        Weight weight;
+        EdgeId first_edge;
+        EdgeId second_edge;
+    };
+
+    explicit ContractionHierarchy(const Graph& graph);
+    explicit ContractionHierarchy(const Graph& graph, std::vector<uint32_t>&& ranks, std::vector<Shortcut>&& shortcuts);
+
+    using RouteBuilder<Weight>::BuildRoute;
+    std::optional<Weight> BuildRoute(VertexId from, VertexId to, std::vector<EdgeId>& edges) const override;
+
+    const std::vector<uint32_t>& GetRanks() const;
+    const std::vector<Shortcut>& GetShortcuts() const;
+
+private:
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr Weight INFINITE_WEIGHT = SearchSpace<Weight>::INFINITE_WEIGHT;
+    static constexpr EdgeId NO_EDGE = SearchSpace<Weight>::NO_EDGE;
+    // Witness searches give up after settling this many vertices; a shortcut is added
+    // whenever no witness is found, which is always safe.
+    static constexpr size_t WITNESS_SETTLED_LIMIT = 100;
+
+    struct Arc {
+        VertexId vertex;
+        Weight weight;
+        EdgeId edge;
+    };
+    using Arcs = std::vector<std::vector<Arc>>;
+
+    // Adjacency of the not yet contracted vertices, used during preprocessing only.
+    struct ContractionState {
+        Arcs out_arcs;
+        Arcs in_arcs;
+        std::vector<bool> contracted;
+        std::vector<int> contracted_neighbors;
+        SearchSpace<Weight> witness_search;
+    };
+
+    void Contract();
+    int ProcessVertex(ContractionState& state, VertexId vertex, std::vector<Shortcut>& shortcuts);
+    void RunWitnessSearch(ContractionState& state, VertexId from, VertexId skipped, Weight max_weight) const;
+    void AddShortcut(ContractionState& state, const Shortcut& shortcut);
+    void BuildSearchGraphs();
+
+    std::pair<VertexId, VertexId> GetEdgeEnds(EdgeId edge_id) const;
+    // Pops the stack until it is empty, appending graph edges to "edges" and expanding shortcuts in place.
+    void UnpackEdges(std::vector<EdgeId>& stack, std::vector<EdgeId>& edges) const;
+
+    const Graph& graph_;
+    std::vector<uint32_t> ranks_;
+    std::vector<Shortcut> shortcuts_;
+
+    // up_arcs_[v] - edges from v to higher ranked vertices (forward search),
+    // down_arcs_[v] - edges into v from higher ranked vertices (backward search).
+    Arcs up_arcs_;
+    Arcs down_arcs_;
+};
+
+template <typename Weight>
+ContractionHierarchy<Weight>::ContractionHierarchy(const Graph& graph)
+    : graph_(graph)
+{
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+    Contract();
+    BuildSearchGraphs();
+}
+
+template <typename Weight>
+ContractionHierarchy<Weight>::ContractionHierarchy(const Graph& graph, std::vector<uint32_t>&& ranks, std::vector<Shortcut>&& shortcuts)
+    : graph_(graph)
+    , ranks_(std::move(ranks))
+    , shortcuts_(std::move(shortcuts))
+{
+    if (ranks_.size() != graph.GetVertexCount()) {
+        throw std::invalid_argument("Contraction hierarchy doesn't match the graph");
+    }
+    BuildSearchGraphs();
+}
+
+template <typename Weight>
+void ContractionHierarchy<Weight>::Contract() {
+    const size_t vertex_count = graph_.GetVertexCount();
+    ContractionState state;
+    state.out_arcs.resize(vertex_count);
+    state.in_arcs.resize(vertex_count);
+    state.contracted.assign(vertex_count, false);
+    state.contracted_neighbors.assign(vertex_count, 0);
+
+    // Only the lightest of parallel edges matters, loops never do.
+    for (EdgeId edge_id = 0; edge_id < graph_.GetEdgeCount(); ++edge_id) {
+        const auto& edge = graph_.GetEdge(edge_id);
+        if (edge.from != edge.to && !graph_.IsRemoved(edge_id)) {
+            state.out_arcs[edge.from].push_back({edge.to, edge.weight, edge_id});
+        }
+    }
+    for (auto& arcs : state.out_arcs) {
+        std::stable_sort(arcs.begin(), arcs.end(), [](const Arc& lhs, const Arc& rhs) {
+            return std::pair{lhs.vertex, lhs.weight} < std::pair{rhs.vertex, rhs.weight};
+        });
+        arcs.erase(std::unique(arcs.begin(), arcs.end(), [](const Arc& lhs, const Arc& rhs) {
+            return lhs.vertex == rhs.vertex;
+        }), arcs.end());
+    }
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        for (const Arc& arc : state.out_arcs[vertex]) {
+            state.in_arcs[arc.vertex].push_back({vertex, arc.weight, arc.edge});
+        }
+    }
+
+    // Lazy updates: a popped vertex is contracted only if its recomputed priority
+    // is still not worse than the best one left in the queue.
+    using Candidate = std::pair<int, VertexId>;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>> queue;
+    std::vector<Shortcut> shortcuts;
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        queue.emplace(ProcessVertex(state, vertex, shortcuts), vertex);
+    }
+
+    ranks_.assign(vertex_count, 0);
+    uint32_t rank = 0;
+    while (!queue.empty()) {
+        const VertexId vertex = queue.top().second;
+        queue.pop();
+        const int priority = ProcessVertex(state, vertex, shortcuts);
+        if (!queue.empty() && priority > queue.top().first) {
+            queue.emplace(priority, vertex);
+            continue;
+        }
+        for (const Shortcut& shortcut : shortcuts) {
+            AddShortcut(state, shortcut);
+        }
+        state.contracted[vertex] = true;
+        ranks_[vertex] = rank++;
+
+        for (const auto* arcs : {&state.out_arcs[vertex], &state.in_arcs[vertex]}) {
+            for (const Arc& arc : *arcs) {
+                ++state.contracted_neighbors[arc.vertex];
+            }
+        }
+        state.out_arcs[vertex].clear();
+        state.in_arcs[vertex].clear();
+    }
+}
+
+// Finds the shortcuts needed to contract the vertex. Returns the priority of the vertex:
+// edge difference plus the number of contracted neighbours.
+template <typename Weight>
+int ContractionHierarchy<Weight>::ProcessVertex(ContractionState& state, VertexId vertex, std::vector<Shortcut>& shortcuts) {
+    auto is_alive = [&state](const Arc& arc) {
+        return !state.contracted[arc.vertex];
+    };
+    auto& out_arcs = state.out_arcs[vertex];
+    auto& in_arcs = state.in_arcs[vertex];
+    out_arcs.erase(std::remove_if(out_arcs.begin(), out_arcs.end(), std::not_fn(is_alive)), out_arcs.end());
+    in_arcs.erase(std::remove_if(in_arcs.begin(), in_arcs.end(), std::not_fn(is_alive)), in_arcs.end());
+
+    shortcuts.clear();
+    for (const Arc& in_arc : in_arcs) {
+        Weight max_out_weight = ZERO_WEIGHT;
+        for (const Arc& out_arc : out_arcs) {
+            if (out_arc.vertex != in_arc.vertex) {
+                max_out_weight = std::max(max_out_weight, out_arc.weight);
+            }
+        }
+        RunWitnessSearch(state, in_arc.vertex, vertex, in_arc.weight + max_out_weight);
+
+        for (const Arc& out_arc : out_arcs) {
+            if (out_arc.vertex == in_arc.vertex) {
+                continue;
+            }
+            const Weight weight = in_arc.weight + out_arc.weight;
+            if (state.witness_search.distances[out_arc.vertex] > weight) {
+                shortcuts.push_back({in_arc.vertex, out_arc.vertex, weight, in_arc.edge, out_arc.edge});
+            }
+        }
+        state.witness_search.Reset();
+    }
+
+    return static_cast<int>(shortcuts.size()) - static_cast<int>(in_arcs.size() + out_arcs.size()) + state.contracted_neighbors[vertex];
+}
+
+template <typename Weight>
+void ContractionHierarchy<Weight>::RunWitnessSearch(ContractionState& state, VertexId from, VertexId skipped, Weight max_weight) const {
+    SearchSpace<Weight>& search_space = state.witness_search;
+    search_space.Prepare(graph_.GetVertexCount());
+    search_space.Reach(from, ZERO_WEIGHT, NO_EDGE);
+
+    size_t settled = 0;
+    VertexId vertex;
+    while (search_space.PopNearest(vertex)) {
+        const Weight distance = search_space.distances[vertex];
+        if (distance > max_weight || ++settled > WITNESS_SETTLED_LIMIT) {
+            break;
+        }
+        for (const Arc& arc : state.out_arcs[vertex]) {
+            if (arc.vertex == skipped || state.contracted[arc.vertex]) {
+                continue;
+            }
+            const Weight candidate_weight = distance + arc.weight;
+            if (candidate_weight < search_space.distances[arc.vertex]) {
+                search_space.Reach(arc.vertex, candidate_weight, arc.edge);
+            }
+        }
+    }
+}
+
+template <typename Weight>
+void ContractionHierarchy<Weight>::AddShortcut(ContractionState& state, const Shortcut& shortcut) {
+    const EdgeId edge_id = graph_.GetEdgeCount() + shortcuts_.size();
+    auto& out_arcs = state.out_arcs[shortcut.from];
+    auto& in_arcs = state.in_arcs[shortcut.to];
+
+    auto out_it = std::find_if(out_arcs.begin(), out_arcs.end(), [&shortcut](const Arc& arc) {
+        return arc.vertex == shortcut.to;
+    });
+    if (out_it == out_arcs.end()) {
+        out_arcs.push_back({shortcut.to, shortcut.weight, edge_id});
+        in_arcs.push_back({shortcut.from, shortcut.weight, edge_id});
+    }
+    else if (shortcut.weight < out_it->weight) {
+        *out_it = {shortcut.to, shortcut.weight, edge_id};
+        *std::find_if(in_arcs.begin(), in_arcs.end(), [&shortcut](const Arc& arc) {
+            return arc.vertex == shortcut.from;
+        }) = {shortcut.from, shortcut.weight, edge_id};
+    }
+    else {
+        return;
+    }
+    shortcuts_.push_back(shortcut);
+}
+
+template <typename Weight>
+void ContractionHierarchy<Weight>::BuildSearchGraphs() {
+    const size_t vertex_count = graph_.GetVertexCount();
+    up_arcs_.assign(vertex_count, {});
+    down_arcs_.assign(vertex_count, {});
+
+    auto add_arc = [this](VertexId from, VertexId to, Weight weight, EdgeId edge_id) {
+        if (ranks_.at(from) < ranks_.at(to)) {
+            up_arcs_[from].push_back({to, weight, edge_id});
+        }
+        else if (ranks_[from] > ranks_[to]) {
+            down_arcs_[to].push_back({from, weight, edge_id});
+        }
+    };
+    for (EdgeId edge_id = 0; edge_id < graph_.GetEdgeCount(); ++edge_id) {
+        if (!graph_.IsRemoved(edge_id)) {
+            const auto& edge = graph_.GetEdge(edge_id);
+            add_arc(edge.from, edge.to, edge.weight, edge_id);
+        }
+    }
+    for (size_t i = 0; i < shortcuts_.size(); ++i) {
+        add_arc(shortcuts_[i].from, shortcuts_[i].to, shortcuts_[i].weight, graph_.GetEdgeCount() + i);
+    }
+}
+
+template <typename Weight>
+std::pair<VertexId, VertexId> ContractionHierarchy<Weight>::GetEdgeEnds(EdgeId edge_id) const {
+    if (edge_id < graph_.GetEdgeCount()) {
+        const auto& edge = graph_.GetEdge(edge_id);
+        return {edge.from, edge.to};
+    }
+    const Shortcut& shortcut = shortcuts_.at(edge_id - graph_.GetEdgeCount());
+    return {shortcut.from, shortcut.to};
+}
+
+template <typename Weight>
+void ContractionHierarchy<Weight>::UnpackEdges(std::vector<EdgeId>& stack, std::vector<EdgeId>& edges) const {
+    while (!stack.empty()) {
+        const EdgeId current = stack.back();
+        stack.pop_back();
+        if (current < graph_.GetEdgeCount()) {
+            edges.push_back(current);
+        }
+        else {
+            const Shortcut& shortcut = shortcuts_[current - graph_.GetEdgeCount()];
+            stack.push_back(shortcut.second_edge);
+            stack.push_back(shortcut.first_edge);
+        }
+    }
+}
+
+template <typename Weight>
+std::optional<Weight> ContractionHierarchy<Weight>::BuildRoute(VertexId from, VertexId to,
+                                                               std::vector<EdgeId>& edges) const {
+    static thread_local SearchSpace<Weight> forward_search;
+    static thread_local SearchSpace<Weight> backward_search;
+    forward_search.Prepare(graph_.GetVertexCount());
+    backward_search.Prepare(graph_.GetVertexCount());
+    forward_search.Reach(from, ZERO_WEIGHT, NO_EDGE);
+    backward_search.Reach(to, ZERO_WEIGHT, NO_EDGE);
+
+    Weight best_weight = INFINITE_WEIGHT;
+    std::optional<VertexId> meeting_vertex;
+
+    auto step = [&](SearchSpace<Weight>& search, const SearchSpace<Weight>& other_search, const Arcs& arcs) {
+        VertexId vertex;
+        if (!search.PopNearest(vertex)) {
+            return;
+        }
+        const Weight distance = search.distances[vertex];
+        if (other_search.IsReached(vertex) && distance + other_search.distances[vertex] < best_weight) {
+            best_weight = distance + other_search.distances[vertex];
+            meeting_vertex = vertex;
+        }
+        for (const Arc& arc : arcs[vertex]) {
+            const Weight candidate_weight = distance + arc.weight;
+            if (candidate_weight < search.distances[arc.vertex]) {
+                search.Reach(arc.vertex, candidate_weight, arc.edge);
+            }
+        }
+    };
+
+    // An upward search can't improve the best route once its nearest vertex is farther than it.
+    while (forward_search.GetMinKey() < best_weight || backward_search.GetMinKey() < best_weight) {
+        if (forward_search.GetMinKey() < best_weight) {
+            step(forward_search, backward_search, up_arcs_);
+        }
+        if (backward_search.GetMinKey() < best_weight) {
+            step(backward_search, forward_search, down_arcs_);
+        }
+    }
+
+    std::optional<Weight> output;
+    edges.clear();
+    if (meeting_vertex) {
+        // The upward half is collected from its last edge, so its first edge is on the top of the stack.
+        static thread_local std::vector<EdgeId> stack;
+        stack.clear();
+        for (EdgeId edge_id = forward_search.prev_edges[*meeting_vertex];
+             edge_id != NO_EDGE;
+             edge_id = forward_search.prev_edges[GetEdgeEnds(edge_id).first])
+        {
+            stack.push_back(edge_id);
+        }
+        UnpackEdges(stack, edges);
+        for (EdgeId edge_id = backward_search.prev_edges[*meeting_vertex];
+             edge_id != NO_EDGE;
+             edge_id = backward_search.prev_edges[GetEdgeEnds(edge_id).second])
+        {
+            stack.push_back(edge_id);
+            UnpackEdges(stack, edges);
+        }
+        output = best_weight;
+    }
+    forward_search.Reset();
+    backward_search.Reset();
+
+    return output;
+}
+
+template <typename Weight>
+const std::vector<uint32_t>& ContractionHierarchy<Weight>::GetRanks() const {
+    return ranks_;
+}
+
+template <typename Weight>
+const std::vector<typename ContractionHierarchy<Weight>::Shortcut>& ContractionHierarchy<Weight>::GetShortcuts() const {
+    return shortcuts_;
+}
+
+}  // namespace graph
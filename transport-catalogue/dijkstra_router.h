@@ -0,0 +1,223 @@
+#pragma once
+
+#include "graph.h"
+#include "route_builder.h"
+#include "weight_traits.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Scratch arrays of a Dijkstra-like search. They are reused from query to query and kept
+// clean between queries: Reset clears only the touched vertices, not the whole arrays.
+template <typename Weight>
+struct SearchSpace {
+    static constexpr Weight INFINITE_WEIGHT = WeightTraits<Weight>::INFINITE_WEIGHT;
+    static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+
+    // A heap entry is ordered by its key: the distance itself for Dijkstra,
+    // the distance plus a lower bound of the remaining part for goal-directed searches.
+    struct HeapEntry {
+        Weight key;
+        Weight distance;
+        VertexId vertex;
+
+        bool operator>(const HeapEntry& other) const {
+            return key > other.key;
+        }
+    };
+
+    std::vector<Weight> distances;
+    std::vector<EdgeId> prev_edges;
+    std::vector<VertexId> touched;
+    std::vector<HeapEntry> heap;
+
+    void Prepare(size_t vertex_count) {
+        if (distances.size() < vertex_count) {
+            distances.resize(vertex_count, INFINITE_WEIGHT);
+            prev_edges.resize(vertex_count, NO_EDGE);
+        }
+    }
+
+    bool IsReached(VertexId vertex) const {
+        return distances[vertex] != INFINITE_WEIGHT;
+    }
+
+    void Reach(VertexId vertex, Weight distance, EdgeId prev_edge) {
+        Reach(vertex, distance, prev_edge, distance);
+    }
+
+    void Reach(VertexId vertex, Weight distance, EdgeId prev_edge, Weight key) {
+        if (distances[vertex] == INFINITE_WEIGHT) {
+            touched.push_back(vertex);
+        }
+        distances[vertex] = distance;
+        prev_edges[vertex] = prev_edge;
+        heap.push_back({key, distance, vertex});
+        std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+    }
+
+    // Pops the vertex with the least key that is still up to date; returns false when the heap is exhausted.
+    bool PopNearest(VertexId& vertex) {
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+            const HeapEntry entry = heap.back();
+            heap.pop_back();
+            if (entry.distance == distances[entry.vertex]) {
+                vertex = entry.vertex;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Weight GetMinKey() const {
+        return heap.empty() ? INFINITE_WEIGHT : heap.front().key;
+    }
+
+    void Reset() {
+        for (const VertexId vertex : touched) {
+            distances[vertex] = INFINITE_WEIGHT;
+            prev_edges[vertex] = NO_EDGE;
+        }
+        touched.clear();
+        heap.clear();
+    }
+};
+
+// Query-time alternative to Router: nothing is precomputed, every BuildRoute
+// runs a binary-heap Dijkstra from "from" and stops as soon as "to" is settled.
+// The search scans the CSR arrays of a frozen graph.
+template <typename Weight>
+class DijkstraRouter final : public RouteBuilder<Weight> {
+
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename RouteBuilder<Weight>::RouteInfo;
+
+    explicit DijkstraRouter(const Graph& graph);
+
+    using RouteBuilder<Weight>::BuildRoute;
+    std::optional<Weight> BuildRoute(VertexId from, VertexId to, std::vector<EdgeId>& edges) const override;
+
+    // Calls callback(vertex, weight, prev_edge) for every vertex reachable from "from"
+    // in order of growing weight; prev_edge is empty for "from" itself.
+    template <typename Callback>
+    void ForEachReachable(VertexId from, Callback&& callback) const;
+
+    // The same for the vertices within max_weight from "from"; heavier ones are not expanded.
+    template <typename Callback>
+    void ForEachReachable(VertexId from, Weight max_weight, Callback&& callback) const;
+
+private:
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr Weight INFINITE_WEIGHT = SearchSpace<Weight>::INFINITE_WEIGHT;
+    static constexpr EdgeId NO_EDGE = SearchSpace<Weight>::NO_EDGE;
+
+    static SearchSpace<Weight>& GetSearchSpace() {
+        static thread_local SearchSpace<Weight> search_space;
+        return search_space;
+    }
+
+    // Settles vertices in order of growing weight and passes each one to on_settle(vertex, weight);
+    // the search stops as soon as on_settle returns false.
+    template <typename Callback>
+    void Search(SearchSpace<Weight>& search_space, VertexId from, Callback&& on_settle) const;
+
+    const Graph& graph_;
+};
+
+template <typename Weight>
+DijkstraRouter<Weight>::DijkstraRouter(const Graph& graph)
+    : graph_(graph)
+{
+    if (!graph.IsFrozen()) {
+        throw std::logic_error("Graph should be frozen before a search");
+    }
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+}
+
+template <typename Weight>
+template <typename Callback>
+void DijkstraRouter<Weight>::Search(SearchSpace<Weight>& search_space, VertexId from, Callback&& on_settle) const {
+    search_space.Prepare(graph_.GetVertexCount());
+    search_space.Reach(from, ZERO_WEIGHT, NO_EDGE);
+
+    const auto& arc_offsets = graph_.GetArcOffsets();
+    const auto& arc_edges = graph_.GetArcEdges();
+    const auto& arc_targets = graph_.GetArcTargets();
+    const auto& arc_weights = graph_.GetArcWeights();
+
+    VertexId vertex;
+    while (search_space.PopNearest(vertex)) {
+        const Weight distance = search_space.distances[vertex];
+        if (!on_settle(vertex, distance)) {
+            break;
+        }
+        for (size_t arc = arc_offsets[vertex]; arc < arc_offsets[vertex + 1]; ++arc) {
+            const Weight candidate_weight = distance + arc_weights[arc];
+            if (candidate_weight < search_space.distances[arc_targets[arc]]) {
+                search_space.Reach(arc_targets[arc], candidate_weight, arc_edges[arc]);
+            }
+        }
+    }
+}
+
+template <typename Weight>
+std::optional<Weight> DijkstraRouter<Weight>::BuildRoute(VertexId from, VertexId to, std::vector<EdgeId>& edges) const {
+    SearchSpace<Weight>& search_space = GetSearchSpace();
+    Search(search_space, from, [to](VertexId vertex, Weight) {
+        return vertex != to;
+    });
+
+    std::optional<Weight> output;
+    edges.clear();
+    if (search_space.IsReached(to)) {
+        for (EdgeId edge_id = search_space.prev_edges[to];
+             edge_id != NO_EDGE;
+             edge_id = search_space.prev_edges[graph_.GetEdge(edge_id).from])
+        {
+            edges.push_back(edge_id);
+        }
+        std::reverse(edges.begin(), edges.end());
+        output = search_space.distances[to];
+    }
+    search_space.Reset();
+
+    return output;
+}
+
+template <typename Weight>
+template <typename Callback>
+void DijkstraRouter<Weight>::ForEachReachable(VertexId from, Callback&& callback) const {
+    ForEachReachable(from, INFINITE_WEIGHT, std::forward<Callback>(callback));
+}
+
+template <typename Weight>
+template <typename Callback>
+void DijkstraRouter<Weight>::ForEachReachable(VertexId from, Weight max_weight, Callback&& callback) const {
+    SearchSpace<Weight>& search_space = GetSearchSpace();
+    Search(search_space, from, [&search_space, &callback, max_weight](VertexId vertex, Weight weight) {
+        if (max_weight < weight) {
+            return false;
+        }
+        const EdgeId prev_edge = search_space.prev_edges[vertex];
+        callback(vertex, weight, prev_edge == NO_EDGE ? std::nullopt : std::optional<EdgeId>(prev_edge));
+        return true;
+    });
+    search_space.Reset();
+}
+
+}  // namespace graph
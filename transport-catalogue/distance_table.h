@@ -0,0 +1,163 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "domain.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DISTANCE_TABLE_SSE2
+#endif
+
+namespace catalogue_core {
+
+namespace transport_catalogue {
+
+// Road lengths between stops in a flat open-addressing table keyed by the packed pair of stop ids.
+// A length set for (from, to) also answers (to, from) until that direction is set itself, so every
+// lookup is a single probe. Keys are kept apart from the lengths and probed a group of GROUP_SIZE
+// at a time: one pass over the group (SSE2 compares where available) tells where the key is
+// or that it is absent, so a probe rarely looks past the first group.
+class DistanceTable {
+
+public:
+	void Set(domain::StopId from, domain::StopId to, int length) {
+		if (2 * (size_ + 2) > keys_.size()) {
+			Rehash(std::max<size_t>(MIN_CAPACITY, 2 * keys_.size()));
+		}
+		Store(ToKey(from, to), { length, false });
+		if (from != to) {
+			const size_t reverse = FindSlot(ToKey(to, from));
+			if (keys_[reverse] == EMPTY_KEY || entries_[reverse].inferred) {
+				Store(ToKey(to, from), { length, true });
+			}
+		}
+	}
+
+	// The length set for (from, to), or else the one set for (to, from).
+	std::optional<int> Get(domain::StopId from, domain::StopId to) const {
+		if (keys_.empty()) {
+			return std::nullopt;
+		}
+		const size_t slot = FindSlot(ToKey(from, to));
+		if (keys_[slot] == EMPTY_KEY) {
+			return std::nullopt;
+		}
+		return entries_[slot].length;
+	}
+
+	// Makes room for count more lengths (two entries each) without rehashing.
+	void Reserve(size_t count) {
+		size_t capacity = std::max<size_t>(keys_.size(), MIN_CAPACITY);
+		while (2 * (size_ + 2 * count) > capacity) {
+			capacity *= 2;
+		}
+		if (capacity != keys_.size()) {
+			Rehash(capacity);
+		}
+	}
+
+	// Calls callback(from, to, length) for every length set explicitly.
+	template <typename Callback>
+	void ForEach(Callback&& callback) const {
+		for (size_t slot = 0; slot < keys_.size(); ++slot) {
+			if (keys_[slot] != EMPTY_KEY && !entries_[slot].inferred) {
+				callback(static_cast<domain::StopId>(keys_[slot] >> 32), static_cast<domain::StopId>(keys_[slot]), entries_[slot].length);
+			}
+		}
+	}
+
+private:
+	struct Entry {
+		int length;
+		bool inferred;
+	};
+
+	static constexpr uint64_t EMPTY_KEY = std::numeric_limits<uint64_t>::max();
+	static constexpr size_t GROUP_SIZE = 8;
+	static constexpr size_t MIN_CAPACITY = 2 * GROUP_SIZE;
+
+	static uint64_t ToKey(domain::StopId from, domain::StopId to) {
+		return static_cast<uint64_t>(from) << 32 | to;
+	}
+
+	// Bit i is set where keys[i] == key, for the GROUP_SIZE keys of a group.
+	static unsigned MatchGroup(const uint64_t* keys, uint64_t key) {
+		unsigned mask = 0;
+#ifdef DISTANCE_TABLE_SSE2
+		const __m128i needle = _mm_set1_epi64x(static_cast<long long>(key));
+		for (size_t i = 0; i < GROUP_SIZE; i += 2) {
+			// SSE2 compares 32-bit halves; a key matches where both of its halves do.
+			const __m128i halves = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), needle);
+			const __m128i matches = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+			mask |= static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(matches))) << i;
+		}
+#else
+		for (size_t i = 0; i < GROUP_SIZE; ++i) {
+			mask |= static_cast<unsigned>(keys[i] == key) << i;
+		}
+#endif
+		return mask;
+	}
+
+	static size_t LowestBit(unsigned mask) {
+		size_t bit = 0;
+		while ((mask & 1u) == 0) {
+			mask >>= 1;
+			++bit;
+		}
+		return bit;
+	}
+
+	// Slot holding the key or the empty slot where it would go. Groups are probed in turn; nothing is
+	// ever erased, so a key is never past the first group with an empty slot. The capacity is a power
+	// of two and the table is at most half full, so the probe ends.
+	size_t FindSlot(uint64_t key) const {
+		const size_t group_mask = keys_.size() / GROUP_SIZE - 1;
+		size_t group = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & group_mask;
+		while (true) {
+			const uint64_t* keys = keys_.data() + group * GROUP_SIZE;
+			if (const unsigned found = MatchGroup(keys, key); found != 0) {
+				return group * GROUP_SIZE + LowestBit(found);
+			}
+			if (const unsigned empty = MatchGroup(keys, EMPTY_KEY); empty != 0) {
+				return group * GROUP_SIZE + LowestBit(empty);
+			}
+			group = (group + 1) & group_mask;
+		}
+	}
+
+	void Store(uint64_t key, Entry entry) {
+		const size_t slot = FindSlot(key);
+		if (keys_[slot] == EMPTY_KEY) {
+			keys_[slot] = key;
+			++size_;
+		}
+		entries_[slot] = entry;
+	}
+
+	void Rehash(size_t capacity) {
+		std::vector<uint64_t> keys(capacity, EMPTY_KEY);
+		std::vector<Entry> entries(capacity);
+		keys.swap(keys_);
+		entries.swap(entries_);
+		size_ = 0;
+		for (size_t slot = 0; slot < keys.size(); ++slot) {
+			if (keys[slot] != EMPTY_KEY) {
+				Store(keys[slot], entries[slot]);
+			}
+		}
+	}
+
+	std::vector<uint64_t> keys_;
+	std::vector<Entry> entries_;
+	size_t size_ = 0;
+};
+
+}
+
+}
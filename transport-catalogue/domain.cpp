@@ -12,9 +12,3 @@
  * Если структура вашего приложения не позволяет так сделать, просто оставьте этот файл пустым.
  *
  */
-namespace domain {
-	size_t StopLengthsHasher::operator()(const std::pair<BusStop*, BusStop*>& stop_len) const {
-
-		return std::hash<void*>{}(&(*stop_len.first)) + std::hash<void*>{}(&(*stop_len.second)) * 17;
-	}
-}
@@ -1,6 +1,7 @@
 #pragma once
 
-#include<string>
+#include<cstdint>
+#include<string_view>
 #include<vector>
 
 #include "geo.h"
@@ -17,6 +18,10 @@
  *
  */
 namespace domain {
+	// Dense handles the catalogue gives stops and buses in the order they are added.
+	using StopId = uint32_t;
+	using BusId = uint32_t;
+
 	struct RouteStatistic {
 		int num_of_stops_;
 		int num_of_unique_stops_;
@@ -24,19 +29,28 @@ namespace domain {
 		double curvature;
 	};
 
+	// Names of added stops and buses point into the name pool of the catalogue;
+	// before that they only have to outlive the call that adds them.
 	struct BusStop {
-		std::string name;
+		std::string_view name;
 		geo::Coordinates coordinates;
+		StopId id = 0;
 	};
 
 	struct BusRoute {
 		bool circular;
-		std::string name;
-		std::vector<BusStop*> stops;
+		std::string_view name;
+		// Resolved with TransportCatalogue::FindBusStop.
+		std::vector<StopId> stops;
+		BusId id = 0;
 	};
 
-	class StopLengthsHasher {
-	public:
-		size_t operator()(const std::pair<BusStop*, BusStop*>& stop_len) const;
+	// Prefix sums along the stops of a bus, so the distance between any two positions is one subtraction:
+	// road[i] is the road distance from the first stop to the i-th one, road_back[i] the road distance
+	// of the way back from the i-th stop to the first one. The great-circle length only goes into
+	// the statistics, which a base stores, so it isn't kept here.
+	struct RouteDistances {
+		std::vector<int> road;
+		std::vector<int> road_back;
 	};
 }
@@ -0,0 +1,314 @@
+#include "floyd_warshall.h"
+#include "weight_traits.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#define FLOYD_WARSHALL_X86
+#define FLOYD_WARSHALL_TARGET_AVX2
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define FLOYD_WARSHALL_X86
+#define FLOYD_WARSHALL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#if defined(FLOYD_WARSHALL_X86) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define FLOYD_WARSHALL_SSE2
+#endif
+
+namespace graph {
+
+namespace {
+
+// 64 x 64 cells: 16 KB of weights and 16 KB of prev edges per tile.
+constexpr size_t TILE_SIZE = 64;
+
+// row[j] = min(row[j], weight_from + through[j]) for j in [0, count); a cell that gets shorter
+// takes the prev edge of the cell it goes through. Infinite weights need no special case:
+// a sum with infinity (saturated for integers) is never less than the current weight.
+template <typename Weight>
+using RelaxRowKernel = void (*)(Weight weight_from, const Weight* weights_through, const uint32_t* prev_edges_through,
+                                Weight* weights_relaxing, uint32_t* prev_edges_relaxing, size_t count);
+
+template <typename Weight>
+void RelaxRowScalar(Weight weight_from, const Weight* weights_through, const uint32_t* prev_edges_through,
+                    Weight* weights_relaxing, uint32_t* prev_edges_relaxing, size_t count) {
+    for (size_t j = 0; j < count; ++j) {
+        const Weight candidate_weight = WeightTraits<Weight>::Add(weight_from, weights_through[j]);
+        const bool shorter = candidate_weight < weights_relaxing[j];
+        weights_relaxing[j] = shorter ? candidate_weight : weights_relaxing[j];
+        prev_edges_relaxing[j] = shorter ? prev_edges_through[j] : prev_edges_relaxing[j];
+    }
+}
+
+#ifdef FLOYD_WARSHALL_SSE2
+void RelaxRowSse2(float weight_from, const float* weights_through, const uint32_t* prev_edges_through,
+                  float* weights_relaxing, uint32_t* prev_edges_relaxing, size_t count) {
+    const __m128 from = _mm_set1_ps(weight_from);
+    size_t j = 0;
+    for (; j + 4 <= count; j += 4) {
+        const __m128 candidate = _mm_add_ps(from, _mm_loadu_ps(weights_through + j));
+        const __m128 current = _mm_loadu_ps(weights_relaxing + j);
+        const __m128 shorter = _mm_cmplt_ps(candidate, current);
+        _mm_storeu_ps(weights_relaxing + j, _mm_or_ps(_mm_and_ps(shorter, candidate), _mm_andnot_ps(shorter, current)));
+
+        const __m128i shorter_mask = _mm_castps_si128(shorter);
+        const __m128i prev_through = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev_edges_through + j));
+        const __m128i prev_current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev_edges_relaxing + j));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(prev_edges_relaxing + j),
+                         _mm_or_si128(_mm_and_si128(shorter_mask, prev_through), _mm_andnot_si128(shorter_mask, prev_current)));
+    }
+    RelaxRowScalar(weight_from, weights_through + j, prev_edges_through + j, weights_relaxing + j, prev_edges_relaxing + j, count - j);
+}
+
+// SSE2 has no unsigned comparison: both sides are shifted by 2^31 and compared as signed.
+// A sum that wrapped around is less than weight_from, which also covers an infinite weights_through[j].
+void RelaxRowSse2(uint32_t weight_from, const uint32_t* weights_through, const uint32_t* prev_edges_through,
+                  uint32_t* weights_relaxing, uint32_t* prev_edges_relaxing, size_t count) {
+    const __m128i sign = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    const __m128i from = _mm_set1_epi32(static_cast<int>(weight_from));
+    const __m128i signed_from = _mm_xor_si128(from, sign);
+    size_t j = 0;
+    for (; j + 4 <= count; j += 4) {
+        const __m128i candidate = _mm_add_epi32(from, _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights_through + j)));
+        const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights_relaxing + j));
+        const __m128i signed_candidate = _mm_xor_si128(candidate, sign);
+        const __m128i wrapped = _mm_cmpgt_epi32(signed_from, signed_candidate);
+        const __m128i shorter = _mm_andnot_si128(wrapped, _mm_cmpgt_epi32(_mm_xor_si128(current, sign), signed_candidate));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(weights_relaxing + j),
+                         _mm_or_si128(_mm_and_si128(shorter, candidate), _mm_andnot_si128(shorter, current)));
+
+        const __m128i prev_through = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev_edges_through + j));
+        const __m128i prev_current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev_edges_relaxing + j));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(prev_edges_relaxing + j),
+                         _mm_or_si128(_mm_and_si128(shorter, prev_through), _mm_andnot_si128(shorter, prev_current)));
+    }
+    RelaxRowScalar(weight_from, weights_through + j, prev_edges_through + j, weights_relaxing + j, prev_edges_relaxing + j, count - j);
+}
+#endif
+
+#ifdef FLOYD_WARSHALL_X86
+FLOYD_WARSHALL_TARGET_AVX2
+void RelaxRowAvx2(float weight_from, const float* weights_through, const uint32_t* prev_edges_through,
+                  float* weights_relaxing, uint32_t* prev_edges_relaxing, size_t count) {
+    const __m256 from = _mm256_set1_ps(weight_from);
+    size_t j = 0;
+    for (; j + 8 <= count; j += 8) {
+        const __m256 candidate = _mm256_add_ps(from, _mm256_loadu_ps(weights_through + j));
+        const __m256 current = _mm256_loadu_ps(weights_relaxing + j);
+        const __m256 shorter = _mm256_cmp_ps(candidate, current, _CMP_LT_OQ);
+        _mm256_storeu_ps(weights_relaxing + j, _mm256_blendv_ps(current, candidate, shorter));
+
+        const __m256 prev_through = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev_edges_through + j)));
+        const __m256 prev_current = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev_edges_relaxing + j)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(prev_edges_relaxing + j),
+                            _mm256_castps_si256(_mm256_blendv_ps(prev_current, prev_through, shorter)));
+    }
+    RelaxRowScalar(weight_from, weights_through + j, prev_edges_through + j, weights_relaxing + j, prev_edges_relaxing + j, count - j);
+}
+
+FLOYD_WARSHALL_TARGET_AVX2
+void RelaxRowAvx2(uint32_t weight_from, const uint32_t* weights_through, const uint32_t* prev_edges_through,
+                  uint32_t* weights_relaxing, uint32_t* prev_edges_relaxing, size_t count) {
+    const __m256i sign = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+    const __m256i from = _mm256_set1_epi32(static_cast<int>(weight_from));
+    const __m256i signed_from = _mm256_xor_si256(from, sign);
+    size_t j = 0;
+    for (; j + 8 <= count; j += 8) {
+        const __m256i candidate = _mm256_add_epi32(from, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights_through + j)));
+        const __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights_relaxing + j));
+        const __m256i signed_candidate = _mm256_xor_si256(candidate, sign);
+        const __m256i wrapped = _mm256_cmpgt_epi32(signed_from, signed_candidate);
+        const __m256i shorter = _mm256_andnot_si256(wrapped, _mm256_cmpgt_epi32(_mm256_xor_si256(current, sign), signed_candidate));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(weights_relaxing + j), _mm256_blendv_epi8(current, candidate, shorter));
+
+        const __m256i prev_through = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev_edges_through + j));
+        const __m256i prev_current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev_edges_relaxing + j));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(prev_edges_relaxing + j), _mm256_blendv_epi8(prev_current, prev_through, shorter));
+    }
+    RelaxRowScalar(weight_from, weights_through + j, prev_edges_through + j, weights_relaxing + j, prev_edges_relaxing + j, count - j);
+}
+
+bool IsAvx2Supported() {
+#ifdef _MSC_VER
+    int registers[4];
+    __cpuid(registers, 0);
+    if (registers[0] < 7) {
+        return false;
+    }
+    __cpuid(registers, 1);
+    const bool has_osxsave = (registers[2] & (1 << 27)) != 0;
+    const bool has_avx = (registers[2] & (1 << 28)) != 0;
+    if (!has_osxsave || !has_avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(registers, 7, 0);
+    return (registers[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+MinPlusKernel DetectMinPlusKernel() {
+#ifdef FLOYD_WARSHALL_X86
+    if (IsAvx2Supported()) {
+        return MinPlusKernel::AVX2;
+    }
+#endif
+#ifdef FLOYD_WARSHALL_SSE2
+    return MinPlusKernel::SSE2;
+#else
+    return MinPlusKernel::SCALAR;
+#endif
+}
+
+template <typename Weight>
+RelaxRowKernel<Weight> GetRelaxRowKernel(MinPlusKernel kernel) {
+    switch (kernel) {
+#ifdef FLOYD_WARSHALL_X86
+    case MinPlusKernel::AVX2:
+        return RelaxRowAvx2;
+#endif
+#ifdef FLOYD_WARSHALL_SSE2
+    case MinPlusKernel::SSE2:
+        return RelaxRowSse2;
+#endif
+    default:
+        return RelaxRowScalar<Weight>;
+    }
+}
+
+template <typename Weight>
+struct Table {
+    size_t vertex_count;
+    Weight* weights;
+    uint32_t* prev_edges;
+    RelaxRowKernel<Weight> relax_row;
+
+    // Relaxes the cells of rows [row_begin, row_end) x columns [column_begin, column_end)
+    // through the vertices [through_begin, through_end), in the order of plain Floyd-Warshall.
+    void RelaxTile(size_t row_begin, size_t row_end, size_t column_begin, size_t column_end,
+                   size_t through_begin, size_t through_end) const {
+        const size_t column_count = column_end - column_begin;
+        for (size_t vertex_through = through_begin; vertex_through < through_end; ++vertex_through) {
+            const Weight* weights_through = weights + vertex_through * vertex_count + column_begin;
+            const uint32_t* prev_edges_through = prev_edges + vertex_through * vertex_count + column_begin;
+
+            for (size_t vertex_from = row_begin; vertex_from < row_end; ++vertex_from) {
+                const Weight weight_from = weights[vertex_from * vertex_count + vertex_through];
+                if (weight_from == WeightTraits<Weight>::INFINITE_WEIGHT) {
+                    continue;
+                }
+                relax_row(weight_from, weights_through, prev_edges_through,
+                          weights + vertex_from * vertex_count + column_begin,
+                          prev_edges + vertex_from * vertex_count + column_begin, column_count);
+            }
+        }
+    }
+};
+
+}  // namespace
+
+MinPlusKernel GetMinPlusKernel() {
+    static const MinPlusKernel kernel = DetectMinPlusKernel();
+    return kernel;
+}
+
+bool IsMinPlusKernelSupported(MinPlusKernel kernel) {
+    switch (kernel) {
+    case MinPlusKernel::AVX2:
+#ifdef FLOYD_WARSHALL_X86
+        return IsAvx2Supported();
+#else
+        return false;
+#endif
+    case MinPlusKernel::SSE2:
+#ifdef FLOYD_WARSHALL_SSE2
+        return true;
+#else
+        return false;
+#endif
+    default:
+        return true;
+    }
+}
+
+namespace {
+
+template <typename Weight>
+void RunRelaxRow(MinPlusKernel kernel, Weight weight_from, const Weight* weights_through, const uint32_t* prev_edges_through,
+                 Weight* weights_relaxing, uint32_t* prev_edges_relaxing, size_t count) {
+    using namespace std::string_literals;
+    if (!IsMinPlusKernelSupported(kernel)) {
+        throw std::invalid_argument("RelaxRow: The min-plus kernel isn't supported"s);
+    }
+    GetRelaxRowKernel<Weight>(kernel)(weight_from, weights_through, prev_edges_through, weights_relaxing, prev_edges_relaxing, count);
+}
+
+}  // namespace
+
+void RelaxRow(MinPlusKernel kernel, float weight_from, const float* weights_through, const uint32_t* prev_edges_through,
+              float* weights_relaxing, uint32_t* prev_edges_relaxing, size_t count) {
+    RunRelaxRow(kernel, weight_from, weights_through, prev_edges_through, weights_relaxing, prev_edges_relaxing, count);
+}
+
+void RelaxRow(MinPlusKernel kernel, uint32_t weight_from, const uint32_t* weights_through, const uint32_t* prev_edges_through,
+              uint32_t* weights_relaxing, uint32_t* prev_edges_relaxing, size_t count) {
+    RunRelaxRow(kernel, weight_from, weights_through, prev_edges_through, weights_relaxing, prev_edges_relaxing, count);
+}
+
+namespace {
+
+template <typename Weight>
+void RunBlockedFloydWarshall(size_t vertex_count, Weight* weights, uint32_t* prev_edges) {
+    const Table<Weight> table{vertex_count, weights, prev_edges, GetRelaxRowKernel<Weight>(GetMinPlusKernel())};
+
+    // Blocked Floyd-Warshall: for every diagonal tile, first the tile itself, then the tiles
+    // of its row and column, which depend only on it, and then all the remaining tiles.
+    for (size_t block_begin = 0; block_begin < vertex_count; block_begin += TILE_SIZE) {
+        const size_t block_end = std::min(block_begin + TILE_SIZE, vertex_count);
+
+        table.RelaxTile(block_begin, block_end, block_begin, block_end, block_begin, block_end);
+
+        for (size_t tile_begin = 0; tile_begin < vertex_count; tile_begin += TILE_SIZE) {
+            if (tile_begin == block_begin) {
+                continue;
+            }
+            const size_t tile_end = std::min(tile_begin + TILE_SIZE, vertex_count);
+            table.RelaxTile(block_begin, block_end, tile_begin, tile_end, block_begin, block_end);
+            table.RelaxTile(tile_begin, tile_end, block_begin, block_end, block_begin, block_end);
+        }
+
+        for (size_t row_begin = 0; row_begin < vertex_count; row_begin += TILE_SIZE) {
+            if (row_begin == block_begin) {
+                continue;
+            }
+            const size_t row_end = std::min(row_begin + TILE_SIZE, vertex_count);
+            for (size_t column_begin = 0; column_begin < vertex_count; column_begin += TILE_SIZE) {
+                if (column_begin == block_begin) {
+                    continue;
+                }
+                const size_t column_end = std::min(column_begin + TILE_SIZE, vertex_count);
+                table.RelaxTile(row_begin, row_end, column_begin, column_end, block_begin, block_end);
+            }
+        }
+    }
+}
+
+}  // namespace
+
+void FloydWarshall(size_t vertex_count, float* weights, uint32_t* prev_edges) {
+    RunBlockedFloydWarshall(vertex_count, weights, prev_edges);
+}
+
+void FloydWarshall(size_t vertex_count, uint32_t* weights, uint32_t* prev_edges) {
+    RunBlockedFloydWarshall(vertex_count, weights, prev_edges);
+}
+
+}  // namespace graph
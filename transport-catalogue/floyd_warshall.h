@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace graph {
+
+// Instruction set of the min-plus kernel used by FloydWarshall; chosen once, at the first call,
+// from what the CPU supports.
+enum class MinPlusKernel {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+MinPlusKernel GetMinPlusKernel();
+
+// Whether both the build and the CPU can run the kernel; SCALAR always can.
+bool IsMinPlusKernelSupported(MinPlusKernel kernel);
+
+// One row step of FloydWarshall on the given kernel, so that the kernels can be checked against each other:
+// weights_relaxing[j] = min(weights_relaxing[j], weight_from + weights_through[j]) for j in [0, count),
+// a cell that gets shorter taking prev_edges_through[j]. Throws std::invalid_argument for an unsupported kernel.
+void RelaxRow(MinPlusKernel kernel, float weight_from, const float* weights_through, const uint32_t* prev_edges_through,
+              float* weights_relaxing, uint32_t* prev_edges_relaxing, size_t count);
+void RelaxRow(MinPlusKernel kernel, uint32_t weight_from, const uint32_t* weights_through, const uint32_t* prev_edges_through,
+              uint32_t* weights_relaxing, uint32_t* prev_edges_relaxing, size_t count);
+
+// Runs Floyd-Warshall in place over a dense row-major vertex_count x vertex_count table.
+// Unreachable cells hold WeightTraits<Weight>::INFINITE_WEIGHT, the cell of a vertex to itself a zero weight.
+// A relaxed cell takes the prev edge of the cell it was relaxed through, as in Router.
+// The table is processed tile by tile, so the three tiles touched by a step stay in cache.
+void FloydWarshall(size_t vertex_count, float* weights, uint32_t* prev_edges);
+void FloydWarshall(size_t vertex_count, uint32_t* weights, uint32_t* prev_edges);
+
+}  // namespace graph
@@ -2,7 +2,9 @@
 
 #include "ranges.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <stdexcept>
 #include <vector>
 
 namespace graph {
@@ -17,6 +19,11 @@ struct Edge {
     Weight weight;
 };
 
+// Edges are added to per-vertex incidence lists; Freeze then moves the adjacency into
+// compressed sparse row arrays: the arcs of vertex v are [arc_offsets[v], arc_offsets[v + 1])
+// of arc_edges/arc_targets/arc_weights, kept in the order the edges were added.
+// EdgeIds are not changed by Freeze. To change a frozen graph, Thaw it, add or remove
+// edges and Freeze it again; removed edges keep their ids but are left out of the arcs.
 template <typename Weight>
 class DirectedWeightedGraph {
 private:
@@ -26,41 +33,177 @@ private:
 public:
     DirectedWeightedGraph() = default;
     explicit DirectedWeightedGraph(size_t vertex_count);
-    explicit DirectedWeightedGraph(std::vector<Edge<Weight>>&& edges, std::vector<IncidenceList>&& incidence_lists)
-                                    : edges_(std::move(edges))
-                                    , incidence_lists_(std::move(incidence_lists)){
-
-    }
+    // Restores a frozen graph from its CSR arrays; ids below edge_count missing from the arcs are removed edges.
+    explicit DirectedWeightedGraph(size_t edge_count,
+                                   std::vector<size_t>&& arc_offsets,
+                                   std::vector<EdgeId>&& arc_edges,
+                                   std::vector<VertexId>&& arc_targets,
+                                   std::vector<Weight>&& arc_weights);
 
     EdgeId AddEdge(const Edge<Weight>& edge);
+    void RemoveEdge(EdgeId edge_id);
+    bool IsRemoved(EdgeId edge_id) const;
+
+    void Freeze();
+    void Thaw();
+    bool IsFrozen() const;
 
     size_t GetVertexCount() const;
     size_t GetEdgeCount() const;
     const Edge<Weight>& GetEdge(EdgeId edge_id) const;
     IncidentEdgesRange GetIncidentEdges(VertexId vertex) const;
+    IncidentEdgesRange GetIncomingEdges(VertexId vertex) const;
 
+    const std::vector<size_t>& GetArcOffsets() const;
+    const std::vector<EdgeId>& GetArcEdges() const;
+    const std::vector<VertexId>& GetArcTargets() const;
+    const std::vector<Weight>& GetArcWeights() const;
 
 private:
+    void BuildIncomingArcs();
+
+    size_t vertex_count_ = 0;
     std::vector<Edge<Weight>> edges_;
+    std::vector<bool> removed_;
     std::vector<IncidenceList> incidence_lists_;
+
+    std::vector<size_t> arc_offsets_;
+    std::vector<EdgeId> arc_edges_;
+    std::vector<VertexId> arc_targets_;
+    std::vector<Weight> arc_weights_;
+
+    std::vector<size_t> incoming_offsets_;
+    std::vector<EdgeId> incoming_edges_;
+    bool frozen_ = false;
 };
 
 template <typename Weight>
 DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count)
-    : incidence_lists_(vertex_count) {
+    : vertex_count_(vertex_count)
+    , incidence_lists_(vertex_count) {
+}
+
+template <typename Weight>
+DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t edge_count,
+                                                     std::vector<size_t>&& arc_offsets,
+                                                     std::vector<EdgeId>&& arc_edges,
+                                                     std::vector<VertexId>&& arc_targets,
+                                                     std::vector<Weight>&& arc_weights)
+    : vertex_count_(arc_offsets.empty() ? 0 : arc_offsets.size() - 1)
+    , arc_offsets_(std::move(arc_offsets))
+    , arc_edges_(std::move(arc_edges))
+    , arc_targets_(std::move(arc_targets))
+    , arc_weights_(std::move(arc_weights))
+    , frozen_(true)
+{
+    if (arc_offsets_.empty() || arc_offsets_.back() != arc_edges_.size()
+        || arc_targets_.size() != arc_edges_.size() || arc_weights_.size() != arc_edges_.size()) {
+        throw std::invalid_argument("Inconsistent CSR arrays");
+    }
+    edges_.resize(edge_count);
+    removed_.assign(edge_count, true);
+    for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+        for (size_t arc = arc_offsets_[vertex]; arc < arc_offsets_[vertex + 1]; ++arc) {
+            edges_.at(arc_edges_[arc]) = {vertex, arc_targets_[arc], arc_weights_[arc]};
+            removed_[arc_edges_[arc]] = false;
+        }
+    }
+    BuildIncomingArcs();
 }
 
 template <typename Weight>
 EdgeId DirectedWeightedGraph<Weight>::AddEdge(const Edge<Weight>& edge) {
+    if (frozen_) {
+        throw std::logic_error("No edges can be added to a frozen graph");
+    }
+    incidence_lists_.at(edge.from).push_back(edges_.size());
     edges_.push_back(edge);
-    const EdgeId id = edges_.size() - 1;
-    incidence_lists_.at(edge.from).push_back(id);
-    return id;
+    removed_.push_back(false);
+    return edges_.size() - 1;
+}
+
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::RemoveEdge(EdgeId edge_id) {
+    if (frozen_) {
+        throw std::logic_error("No edges can be removed from a frozen graph");
+    }
+    if (removed_.at(edge_id)) {
+        return;
+    }
+    auto& incidence_list = incidence_lists_[edges_[edge_id].from];
+    incidence_list.erase(std::find(incidence_list.begin(), incidence_list.end(), edge_id));
+    removed_[edge_id] = true;
+}
+
+template <typename Weight>
+bool DirectedWeightedGraph<Weight>::IsRemoved(EdgeId edge_id) const {
+    return removed_[edge_id];
+}
+
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::Freeze() {
+    if (frozen_) {
+        return;
+    }
+    arc_offsets_.assign(vertex_count_ + 1, 0);
+    arc_edges_.clear();
+    arc_edges_.reserve(edges_.size());
+    for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+        arc_edges_.insert(arc_edges_.end(), incidence_lists_[vertex].begin(), incidence_lists_[vertex].end());
+        arc_offsets_[vertex + 1] = arc_edges_.size();
+    }
+    arc_targets_.resize(arc_edges_.size());
+    arc_weights_.resize(arc_edges_.size());
+    for (size_t arc = 0; arc < arc_edges_.size(); ++arc) {
+        arc_targets_[arc] = edges_[arc_edges_[arc]].to;
+        arc_weights_[arc] = edges_[arc_edges_[arc]].weight;
+    }
+    std::vector<IncidenceList>().swap(incidence_lists_);
+
+    BuildIncomingArcs();
+    frozen_ = true;
+}
+
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::Thaw() {
+    if (!frozen_) {
+        return;
+    }
+    incidence_lists_.assign(vertex_count_, {});
+    for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+        incidence_lists_[vertex].assign(arc_edges_.begin() + arc_offsets_[vertex], arc_edges_.begin() + arc_offsets_[vertex + 1]);
+    }
+    frozen_ = false;
+}
+
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::BuildIncomingArcs() {
+    incoming_offsets_.assign(vertex_count_ + 1, 0);
+    for (EdgeId edge_id = 0; edge_id < edges_.size(); ++edge_id) {
+        if (!removed_[edge_id]) {
+            ++incoming_offsets_.at(edges_[edge_id].to + 1);
+        }
+    }
+    for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+        incoming_offsets_[vertex + 1] += incoming_offsets_[vertex];
+    }
+    incoming_edges_.resize(incoming_offsets_.back());
+    std::vector<size_t> positions(incoming_offsets_.begin(), incoming_offsets_.end() - 1);
+    for (EdgeId edge_id = 0; edge_id < edges_.size(); ++edge_id) {
+        if (!removed_[edge_id]) {
+            incoming_edges_[positions[edges_[edge_id].to]++] = edge_id;
+        }
+    }
+}
+
+template <typename Weight>
+bool DirectedWeightedGraph<Weight>::IsFrozen() const {
+    return frozen_;
 }
 
 template <typename Weight>
 size_t DirectedWeightedGraph<Weight>::GetVertexCount() const {
-    return incidence_lists_.size();
+    return vertex_count_;
 }
 
 template <typename Weight>
@@ -70,12 +213,44 @@ size_t DirectedWeightedGraph<Weight>::GetEdgeCount() const {
 
 template <typename Weight>
 const Edge<Weight>& DirectedWeightedGraph<Weight>::GetEdge(EdgeId edge_id) const {
-    return edges_.at(edge_id);
+    return edges_[edge_id];
 }
 
 template <typename Weight>
 typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
 DirectedWeightedGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
-    return ranges::AsRange(incidence_lists_.at(vertex));
+    if (!frozen_) {
+        return ranges::AsRange(incidence_lists_.at(vertex));
+    }
+    return {arc_edges_.begin() + arc_offsets_.at(vertex), arc_edges_.begin() + arc_offsets_.at(vertex + 1)};
+}
+
+template <typename Weight>
+typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
+DirectedWeightedGraph<Weight>::GetIncomingEdges(VertexId vertex) const {
+    if (!frozen_) {
+        throw std::logic_error("Incoming edges are known only for a frozen graph");
+    }
+    return {incoming_edges_.begin() + incoming_offsets_.at(vertex), incoming_edges_.begin() + incoming_offsets_.at(vertex + 1)};
+}
+
+template <typename Weight>
+const std::vector<size_t>& DirectedWeightedGraph<Weight>::GetArcOffsets() const {
+    return arc_offsets_;
+}
+
+template <typename Weight>
+const std::vector<EdgeId>& DirectedWeightedGraph<Weight>::GetArcEdges() const {
+    return arc_edges_;
+}
+
+template <typename Weight>
+const std::vector<VertexId>& DirectedWeightedGraph<Weight>::GetArcTargets() const {
+    return arc_targets_;
+}
+
+template <typename Weight>
+const std::vector<Weight>& DirectedWeightedGraph<Weight>::GetArcWeights() const {
+    return arc_weights_;
 }
-}  // namespace graph
\ No newline at end of file
+}  // namespace graph
@@ -0,0 +1,292 @@
+#pragma once
+
+#include "graph.h"
+#include "route_builder.h"
+#include "dijkstra_router.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// 2-hop hub labeling built by pruned landmark labeling. Every vertex keeps an out-label: hubs it
+// reaches with their weights, and an in-label: hubs it is reached from. The lightest route from s
+// to t goes through a hub found in both the out-label of s and the in-label of t, so a query is a
+// merge of two label runs sorted by hub rank. Vertices become hubs in the order of their degrees;
+// a search from a hub skips every vertex whose distance the earlier hubs already cover.
+//
+// Every label entry keeps the edge of its vertex on the route to (or from) the hub; the searches
+// only expand the vertices they label, so the next vertex of such a route has an entry for the
+// same hub and the route is unpacked entry by entry.
+template <typename Weight>
+class HubLabels final : public RouteBuilder<Weight> {
+
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename RouteBuilder<Weight>::RouteInfo;
+
+    static constexpr uint32_t NO_EDGE = std::numeric_limits<uint32_t>::max();
+
+    // Labels of one direction: the entries of vertex v are [offsets[v], offsets[v + 1]),
+    // sorted by hub rank. The entry of a hub in its own label has no parent edge.
+    struct LabelSet {
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> hubs;
+        std::vector<Weight> distances;
+        std::vector<uint32_t> parent_edges;
+    };
+
+    explicit HubLabels(const Graph& graph);
+    explicit HubLabels(const Graph& graph, std::vector<VertexId>&& hub_vertices, LabelSet&& out_labels, LabelSet&& in_labels);
+
+    using RouteBuilder<Weight>::BuildRoute;
+    std::optional<Weight> BuildRoute(VertexId from, VertexId to, std::vector<EdgeId>& edges) const override;
+
+    // Vertices in the order of their hub ranks.
+    const std::vector<VertexId>& GetHubVertices() const;
+    const LabelSet& GetOutLabels() const;
+    const LabelSet& GetInLabels() const;
+
+private:
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr Weight INFINITE_WEIGHT = SearchSpace<Weight>::INFINITE_WEIGHT;
+
+    struct LabelEntry {
+        uint32_t hub;
+        Weight distance;
+        uint32_t parent_edge;
+    };
+    using Labels = std::vector<std::vector<LabelEntry>>;
+
+    // Labels every vertex the hub of the given rank reaches (forward) or is reached from (backward)
+    // and whose distance isn't covered yet; hub_distances are indexed by rank and kept infinite between calls.
+    void RunPrunedSearch(uint32_t rank, bool forward, Labels& out_labels, Labels& in_labels,
+                         std::vector<Weight>& hub_distances, SearchSpace<Weight>& search_space) const;
+    static LabelSet Compress(Labels&& labels);
+    static void CheckLabelSet(const LabelSet& labels, size_t vertex_count);
+
+    // Index of the entry of the hub in the label of vertex.
+    size_t FindEntry(const LabelSet& labels, VertexId vertex, uint32_t hub) const;
+
+    const Graph& graph_;
+    std::vector<VertexId> hub_vertices_;
+    LabelSet out_labels_;
+    LabelSet in_labels_;
+};
+
+template <typename Weight>
+HubLabels<Weight>::HubLabels(const Graph& graph)
+    : graph_(graph)
+{
+    if (!graph.IsFrozen()) {
+        throw std::logic_error("Graph should be frozen before a search");
+    }
+    if (graph.GetEdgeCount() >= NO_EDGE) {
+        throw std::length_error("Too many edges for hub labels");
+    }
+    const size_t vertex_count = graph.GetVertexCount();
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+
+    // Busy vertices lie on many routes, so labelling from them first prunes the most.
+    std::vector<size_t> degrees(vertex_count);
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        const auto incoming_edges = graph.GetIncomingEdges(vertex);
+        degrees[vertex] = graph.GetArcOffsets()[vertex + 1] - graph.GetArcOffsets()[vertex]
+                          + static_cast<size_t>(std::distance(incoming_edges.begin(), incoming_edges.end()));
+    }
+    hub_vertices_.resize(vertex_count);
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        hub_vertices_[vertex] = vertex;
+    }
+    std::stable_sort(hub_vertices_.begin(), hub_vertices_.end(), [&degrees](VertexId lhs, VertexId rhs) {
+        return degrees[lhs] > degrees[rhs];
+    });
+
+    Labels out_labels(vertex_count);
+    Labels in_labels(vertex_count);
+    std::vector<Weight> hub_distances(vertex_count, INFINITE_WEIGHT);
+    SearchSpace<Weight> search_space;
+    for (uint32_t rank = 0; rank < vertex_count; ++rank) {
+        RunPrunedSearch(rank, true, out_labels, in_labels, hub_distances, search_space);
+        RunPrunedSearch(rank, false, out_labels, in_labels, hub_distances, search_space);
+    }
+    out_labels_ = Compress(std::move(out_labels));
+    in_labels_ = Compress(std::move(in_labels));
+}
+
+template <typename Weight>
+HubLabels<Weight>::HubLabels(const Graph& graph, std::vector<VertexId>&& hub_vertices, LabelSet&& out_labels, LabelSet&& in_labels)
+    : graph_(graph)
+    , hub_vertices_(std::move(hub_vertices))
+    , out_labels_(std::move(out_labels))
+    , in_labels_(std::move(in_labels))
+{
+    if (hub_vertices_.size() != graph.GetVertexCount()) {
+        throw std::invalid_argument("Hub labels don't match the graph");
+    }
+    CheckLabelSet(out_labels_, graph.GetVertexCount());
+    CheckLabelSet(in_labels_, graph.GetVertexCount());
+}
+
+template <typename Weight>
+void HubLabels<Weight>::RunPrunedSearch(uint32_t rank, bool forward, Labels& out_labels, Labels& in_labels,
+                                        std::vector<Weight>& hub_distances, SearchSpace<Weight>& search_space) const {
+    const VertexId hub = hub_vertices_[rank];
+    // A forward search finds d(hub, v) and is covered by out(hub) + in(v); a backward one the other way round.
+    const std::vector<LabelEntry>& hub_label = forward ? out_labels[hub] : in_labels[hub];
+    Labels& labelled = forward ? in_labels : out_labels;
+    for (const LabelEntry& entry : hub_label) {
+        hub_distances[entry.hub] = entry.distance;
+    }
+
+    search_space.Prepare(graph_.GetVertexCount());
+    search_space.Reach(hub, ZERO_WEIGHT, SearchSpace<Weight>::NO_EDGE);
+    VertexId vertex;
+    while (search_space.PopNearest(vertex)) {
+        const Weight distance = search_space.distances[vertex];
+        const bool covered = std::any_of(labelled[vertex].begin(), labelled[vertex].end(), [&hub_distances, distance](const LabelEntry& entry) {
+            return hub_distances[entry.hub] != INFINITE_WEIGHT && hub_distances[entry.hub] + entry.distance <= distance;
+        });
+        if (covered) {
+            continue;
+        }
+        const EdgeId prev_edge = search_space.prev_edges[vertex];
+        labelled[vertex].push_back({rank, distance, prev_edge == SearchSpace<Weight>::NO_EDGE ? NO_EDGE : static_cast<uint32_t>(prev_edge)});
+
+        if (forward) {
+            for (size_t arc = graph_.GetArcOffsets()[vertex]; arc < graph_.GetArcOffsets()[vertex + 1]; ++arc) {
+                const Weight candidate_weight = distance + graph_.GetArcWeights()[arc];
+                if (candidate_weight < search_space.distances[graph_.GetArcTargets()[arc]]) {
+                    search_space.Reach(graph_.GetArcTargets()[arc], candidate_weight, graph_.GetArcEdges()[arc]);
+                }
+            }
+        } else {
+            for (const EdgeId edge_id : graph_.GetIncomingEdges(vertex)) {
+                const auto& edge = graph_.GetEdge(edge_id);
+                const Weight candidate_weight = distance + edge.weight;
+                if (candidate_weight < search_space.distances[edge.from]) {
+                    search_space.Reach(edge.from, candidate_weight, edge_id);
+                }
+            }
+        }
+    }
+    search_space.Reset();
+
+    for (const LabelEntry& entry : hub_label) {
+        hub_distances[entry.hub] = INFINITE_WEIGHT;
+    }
+}
+
+template <typename Weight>
+typename HubLabels<Weight>::LabelSet HubLabels<Weight>::Compress(Labels&& labels) {
+    LabelSet output;
+    output.offsets.reserve(labels.size() + 1);
+    output.offsets.push_back(0);
+    for (auto& label : labels) {
+        for (const LabelEntry& entry : label) {
+            output.hubs.push_back(entry.hub);
+            output.distances.push_back(entry.distance);
+            output.parent_edges.push_back(entry.parent_edge);
+        }
+        output.offsets.push_back(static_cast<uint32_t>(output.hubs.size()));
+        label = {};
+    }
+    return output;
+}
+
+template <typename Weight>
+void HubLabels<Weight>::CheckLabelSet(const LabelSet& labels, size_t vertex_count) {
+    if (labels.offsets.size() != vertex_count + 1 || labels.offsets.back() != labels.hubs.size()
+        || labels.distances.size() != labels.hubs.size() || labels.parent_edges.size() != labels.hubs.size()) {
+        throw std::invalid_argument("Inconsistent hub labels");
+    }
+}
+
+template <typename Weight>
+size_t HubLabels<Weight>::FindEntry(const LabelSet& labels, VertexId vertex, uint32_t hub) const {
+    const auto begin = labels.hubs.begin() + labels.offsets[vertex];
+    const auto end = labels.hubs.begin() + labels.offsets[vertex + 1];
+    const auto it = std::lower_bound(begin, end, hub);
+    if (it == end || *it != hub) {
+        throw std::logic_error("Hub labels: broken route to a hub");
+    }
+    return static_cast<size_t>(it - labels.hubs.begin());
+}
+
+template <typename Weight>
+std::optional<Weight> HubLabels<Weight>::BuildRoute(VertexId from, VertexId to, std::vector<EdgeId>& edges) const {
+    if (from >= hub_vertices_.size() || to >= hub_vertices_.size()) {
+        throw std::out_of_range("HubLabels: unknown vertex");
+    }
+    edges.clear();
+
+    Weight best_weight = INFINITE_WEIGHT;
+    uint32_t best_hub = 0;
+    for (size_t out_index = out_labels_.offsets[from], in_index = in_labels_.offsets[to];
+         out_index < out_labels_.offsets[from + 1] && in_index < in_labels_.offsets[to + 1];)
+    {
+        const uint32_t out_hub = out_labels_.hubs[out_index];
+        const uint32_t in_hub = in_labels_.hubs[in_index];
+        if (out_hub < in_hub) {
+            ++out_index;
+        } else if (in_hub < out_hub) {
+            ++in_index;
+        } else {
+            const Weight weight = out_labels_.distances[out_index] + in_labels_.distances[in_index];
+            if (weight < best_weight) {
+                best_weight = weight;
+                best_hub = out_hub;
+            }
+            ++out_index;
+            ++in_index;
+        }
+    }
+    if (best_weight == INFINITE_WEIGHT) {
+        return std::nullopt;
+    }
+
+    const VertexId hub = hub_vertices_[best_hub];
+    for (VertexId vertex = from; vertex != hub;) {
+        const uint32_t edge_id = out_labels_.parent_edges[FindEntry(out_labels_, vertex, best_hub)];
+        edges.push_back(edge_id);
+        vertex = graph_.GetEdge(edge_id).to;
+    }
+    const size_t hub_position = edges.size();
+    for (VertexId vertex = to; vertex != hub;) {
+        const uint32_t edge_id = in_labels_.parent_edges[FindEntry(in_labels_, vertex, best_hub)];
+        edges.push_back(edge_id);
+        vertex = graph_.GetEdge(edge_id).from;
+    }
+    std::reverse(edges.begin() + hub_position, edges.end());
+
+    return best_weight;
+}
+
+template <typename Weight>
+const std::vector<VertexId>& HubLabels<Weight>::GetHubVertices() const {
+    return hub_vertices_;
+}
+
+template <typename Weight>
+const typename HubLabels<Weight>::LabelSet& HubLabels<Weight>::GetOutLabels() const {
+    return out_labels_;
+}
+
+template <typename Weight>
+const typename HubLabels<Weight>::LabelSet& HubLabels<Weight>::GetInLabels() const {
+    return in_labels_;
+}
+
+}  // namespace graph
@@ -36,7 +36,7 @@ namespace catalogue_core {
 		}
 	}
 
-	void JSONReader::AddStopsAndRoutes(const json::Dict& doc) {
+	void JSONReader::AddStopsAndRoutes(const json::Dict& doc, size_t thread_count) {
 
 		if (doc.count("base_requests"s) == 0) {
 			return;
@@ -68,7 +68,7 @@ namespace catalogue_core {
 				request_handler_->AddRoutesToBuffer(q.bus_route);
 			}
 		}
-		request_handler_->LoadBufferToCatalogue();
+		request_handler_->LoadBufferToCatalogue(thread_count);
 
 	}
 
@@ -132,16 +132,30 @@ namespace catalogue_core {
 			else if (stat_request.AsDict().at("type"s) == "Route"s) {
 				q.type = QueryToBaseType::ROUTE_BUILD;
 				
-				auto route = request_handler_->BuildFastestRoute(stat_request.AsDict().at("from"s).AsString(), stat_request.AsDict().at("to"s).AsString());
+				auto total_time = request_handler_->BuildFastestRoute(stat_request.AsDict().at("from"s).AsString(), stat_request.AsDict().at("to"s).AsString(), itinerary_);
 
-				if (route.has_value()) {
-					PrintFastestRoute(route.value(), q.id, os);
+				if (total_time.has_value()) {
+					PrintFastestRoute(itinerary_, total_time.value(), q.id, os);
 				}
 				else {
 					ErrorMessage(q.id, os);
 				}
 
 			}
+			else if (stat_request.AsDict().at("type"s) == "Reachable"s) {
+				const double max_time = stat_request.AsDict().at("max_time"s).AsDouble();
+				if (max_time < 0.0) {
+					throw std::invalid_argument("ToProcessTheRequests: max_time should be non-negative"s);
+				}
+				auto stops = request_handler_->FindReachableStops(stat_request.AsDict().at("from"s).AsString(), max_time);
+
+				if (stops.has_value()) {
+					PrintReachableStops(stops.value(), q.id, os);
+				}
+				else {
+					ErrorMessage(q.id, os);
+				}
+			}
 			else if (stat_request.AsDict().at("type"s) == "Map"s) {
 				std::ostringstream output;
 				request_handler_->RenderMap(output);
@@ -194,13 +208,55 @@ namespace catalogue_core {
 		request_handler_->LoadRendererSettings(std::move(settings));		
 	}
 
-	void JSONReader::CreateRouter(const json::Dict& doc) {
+	// A negative count would turn into a huge size_t: a thread or allocation bomb.
+	size_t AsCount(const json::Node& node, const std::string& setting_name) {
+		const int value = node.AsInt();
+		if (value < 0) {
+			throw std::invalid_argument("ReadRouterSettings: "s + setting_name + " should be non-negative"s);
+		}
+		return static_cast<size_t>(value);
+	}
+
+	router::RouterSettings JSONReader::ReadRouterSettings(const json::Dict& doc) const {
 		router::RouterSettings settings;
 		if (doc.count("bus_wait_time"s))
 			settings.bus_wait_time = doc.at("bus_wait_time"s).AsInt();
 		if (doc.count("bus_velocity"s))
 			settings.bus_velocity = doc.at("bus_velocity"s).AsDouble();
-		request_handler_->CreateRouter(settings);
+		if (doc.count("routing_engine"s)) {
+			const std::string& engine = const_cast<json::Node&>(doc.at("routing_engine"s)).AsString();
+			if (engine == "precomputed"s)
+				settings.engine = router::RouterEngine::PRECOMPUTED;
+			else if (engine == "dijkstra"s)
+				settings.engine = router::RouterEngine::DIJKSTRA;
+			else if (engine == "contraction_hierarchy"s)
+				settings.engine = router::RouterEngine::CONTRACTION_HIERARCHY;
+			else if (engine == "raptor"s)
+				settings.engine = router::RouterEngine::RAPTOR;
+			else if (engine == "bidirectional_dijkstra"s)
+				settings.engine = router::RouterEngine::BIDIRECTIONAL_DIJKSTRA;
+			else if (engine == "a_star"s)
+				settings.engine = router::RouterEngine::A_STAR;
+			else if (engine == "alt"s)
+				settings.engine = router::RouterEngine::ALT;
+			else if (engine == "hub_labels"s)
+				settings.engine = router::RouterEngine::HUB_LABELS;
+			else
+				throw std::invalid_argument("ReadRouterSettings: Unknown routing engine"s);
+		}
+		if (doc.count("fold_wait_edges"s))
+			settings.fold_wait_edges = doc.at("fold_wait_edges"s).AsBool();
+		if (doc.count("route_cache_size"s))
+			settings.route_cache_size = AsCount(doc.at("route_cache_size"s), "route_cache_size"s);
+		if (doc.count("landmark_count"s))
+			settings.landmark_count = AsCount(doc.at("landmark_count"s), "landmark_count"s);
+		if (doc.count("parallel_precompute"s))
+			settings.parallel_precompute = doc.at("parallel_precompute"s).AsBool();
+		if (doc.count("precompute_threads"s))
+			settings.precompute_threads = AsCount(doc.at("precompute_threads"s), "precompute_threads"s);
+		if (doc.count("report_progress"s))
+			settings.report_progress = doc.at("report_progress"s).AsBool();
+		return settings;
 	}
 
 	void JSONReader::ProcessRequests(std::istream& is, [[maybe_unused]]std::ostream& os) {
@@ -211,11 +267,17 @@ namespace catalogue_core {
 
 		std::map<std::string, json::Node> doc = const_cast<json::Node&>(json::Load(is).GetRoot()).AsDict();
 
-		AddStopsAndRoutes(doc);
+		// Routing settings are read first: their thread count also serves the catalogue.
+		std::optional<router::RouterSettings> router_settings;
+		if (doc.count("routing_settings"s)) {
+			router_settings = ReadRouterSettings(doc.at("routing_settings"s).AsDict());
+		}
+
+		AddStopsAndRoutes(doc, router_settings.value_or(router::RouterSettings{}).precompute_threads);
 		if (doc.count("render_settings"s))
 			FillRenderSettings(doc.at("render_settings"s).AsDict());
-		if (doc.count("routing_settings"s)) {
-			CreateRouter(doc.at("routing_settings"s).AsDict());
+		if (router_settings.has_value()) {
+			request_handler_->CreateRouter(*router_settings);
 		}
 		if (doc.count("serialization_settings"s)) {
 			auto settings = doc.at("serialization_settings"s).AsDict();
@@ -277,14 +339,14 @@ namespace catalogue_core {
 		);
 	}
 
-	void JSONReader::PrintFastestRoute(const std::pair<std::vector<router::RoutePart>, double>& input, int id, std::ostream& os) const {
+	void JSONReader::PrintFastestRoute(const std::vector<router::RoutePart>& itinerary, double total_time, int id, std::ostream& os) const {
 
 		auto first_part = json::Builder{}.StartDict()
 			.Key("request_id"s).Value(id)
-			.Key("total_time"s).Value(input.second)
+			.Key("total_time"s).Value(total_time)
 			.Key("items"s).StartArray();
 
-		for (const auto& part : input.first) {
+		for (const auto& part : itinerary) {
 			if (part.wait_or_bus == router::WaitOrBus::WAIT) {
 				first_part.StartDict()
 					.Key("type"s).Value("Wait"s)
@@ -305,6 +367,22 @@ namespace catalogue_core {
 		json::Print(json::Document{ first_part.EndArray().EndDict().Build()}, os	);
 	}
 
+	void JSONReader::PrintReachableStops(const std::vector<std::pair<const domain::BusStop*, double>>& input, int id, std::ostream& os) const {
+
+		auto first_part = json::Builder{}.StartDict()
+			.Key("request_id"s).Value(id)
+			.Key("stops"s).StartArray();
+
+		for (const auto& [stop, time] : input) {
+			first_part.StartDict()
+				.Key("stop_name"s).Value(std::string(stop->name))
+				.Key("time"s).Value(time)
+				.EndDict();
+		}
+
+		json::Print(json::Document{ first_part.EndArray().EndDict().Build() }, os);
+	}
+
 	void JSONReader::ErrorMessage(int id, std::ostream& os) const {
 		
 		json::Print(
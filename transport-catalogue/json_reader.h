@@ -23,8 +23,8 @@ namespace catalogue_core {
 
 	private:
 
-		void AddStopsAndRoutes(const json::Dict& doc);
-		void CreateRouter(const json::Dict& doc);
+		void AddStopsAndRoutes(const json::Dict& doc, size_t thread_count);
+		router::RouterSettings ReadRouterSettings(const json::Dict& doc) const;
 		void SerializeCatalogue();
 
 		void ToProcessTheRequests(const json::Dict& doc, std::ostream& os);
@@ -34,11 +34,14 @@ namespace catalogue_core {
 		void FillSerializeSettings( json::Dict& doc);
 		void GetAndPrintInformation(std::ostream& os) const;
 
-		void PrintFastestRoute(const std::pair<std::vector<router::RoutePart>, double>& input, int id, std::ostream& os) const;
+		void PrintFastestRoute(const std::vector<router::RoutePart>& itinerary, double total_time, int id, std::ostream& os) const;
+		void PrintReachableStops(const std::vector<std::pair<const domain::BusStop*, double>>& input, int id, std::ostream& os) const;
 		void PrintInformationAboutBus(const domain::RouteStatistic& output, int id, std::ostream& os) const;
 		void PrintInformationAboutStop(const std::set<std::string_view, std::less<>>& output, int id, std::ostream& os) const;
 		void ErrorMessage(int id, std::ostream& os) const;
 
 		RequestHandler* request_handler_;
+		// Reused by every Route request, so answering them does not allocate once it has grown.
+		std::vector<router::RoutePart> itinerary_;
 	};
 }
\ No newline at end of file
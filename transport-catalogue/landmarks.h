@@ -0,0 +1,183 @@
+#pragma once
+
+#include "graph.h"
+#include "parallel.h"
+#include "weight_traits.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Weights of the lightest routes between a few landmark vertices and every vertex, for the ALT
+// lower bounds (A*, landmarks, triangle inequality): for a landmark L and any route v -> t,
+// weight(v, t) >= d(L, t) - d(L, v) and weight(v, t) >= d(v, L) - d(t, L).
+// The tables take O(landmarks * V) and are stored vertex by vertex, so a bound reads two short runs.
+template <typename Weight>
+class Landmarks {
+
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    // Picks landmark_count landmarks by farthest-point selection: every next one is the vertex
+    // farthest from the landmarks already chosen, an unreachable one first.
+    explicit Landmarks(const Graph& graph, size_t landmark_count, size_t thread_count = 0);
+    explicit Landmarks(size_t vertex_count, std::vector<VertexId>&& vertices,
+                       std::vector<Weight>&& distances_from, std::vector<Weight>&& distances_to);
+
+    Weight GetLowerBound(VertexId from, VertexId to) const;
+
+    const std::vector<VertexId>& GetVertices() const {
+        return vertices_;
+    }
+
+    // [vertex * landmarks + i] is the weight from the i-th landmark to vertex.
+    const std::vector<Weight>& GetDistancesFrom() const {
+        return distances_from_;
+    }
+
+    // [vertex * landmarks + i] is the weight from vertex to the i-th landmark.
+    const std::vector<Weight>& GetDistancesTo() const {
+        return distances_to_;
+    }
+
+private:
+    static constexpr Weight ZERO_WEIGHT = WeightTraits<Weight>::ZERO_WEIGHT;
+    static constexpr Weight INFINITE_WEIGHT = WeightTraits<Weight>::INFINITE_WEIGHT;
+
+    // Weights of the lightest routes from source to every vertex, or from every vertex to source.
+    static std::vector<Weight> ComputeDistances(const Graph& graph, VertexId source, bool backward);
+
+    void StoreDistances(size_t landmark, const std::vector<Weight>& distances, std::vector<Weight>& table) const;
+
+    size_t vertex_count_;
+    std::vector<VertexId> vertices_;
+    std::vector<Weight> distances_from_;
+    std::vector<Weight> distances_to_;
+};
+
+template <typename Weight>
+Landmarks<Weight>::Landmarks(const Graph& graph, size_t landmark_count, size_t thread_count)
+    : vertex_count_(graph.GetVertexCount())
+{
+    if (!graph.IsFrozen()) {
+        throw std::logic_error("Graph should be frozen before a search");
+    }
+    landmark_count = std::min(landmark_count, vertex_count_);
+    distances_from_.resize(vertex_count_ * landmark_count);
+    distances_to_.resize(vertex_count_ * landmark_count);
+
+    // The first landmark is the vertex farthest from vertex 0, every next one is the farthest from all chosen.
+    std::vector<bool> is_landmark(vertex_count_, false);
+    std::vector<Weight> nearest_landmark_distances;
+    if (landmark_count != 0) {
+        nearest_landmark_distances = ComputeDistances(graph, 0, false);
+    }
+    for (size_t landmark = 0; landmark < landmark_count; ++landmark) {
+        VertexId farthest = vertex_count_;
+        for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+            if (!is_landmark[vertex]
+                && (farthest == vertex_count_ || nearest_landmark_distances[vertex] > nearest_landmark_distances[farthest])) {
+                farthest = vertex;
+            }
+        }
+        is_landmark[farthest] = true;
+        vertices_.push_back(farthest);
+
+        const std::vector<Weight> distances = ComputeDistances(graph, farthest, false);
+        StoreDistances(landmark, distances, distances_from_);
+        for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+            nearest_landmark_distances[vertex] = landmark == 0 ? distances[vertex]
+                                                               : std::min(nearest_landmark_distances[vertex], distances[vertex]);
+        }
+    }
+
+    parallel::ForEachIndex(landmark_count, thread_count, [this, &graph](size_t landmark) {
+        StoreDistances(landmark, ComputeDistances(graph, vertices_[landmark], true), distances_to_);
+    });
+}
+
+template <typename Weight>
+Landmarks<Weight>::Landmarks(size_t vertex_count, std::vector<VertexId>&& vertices,
+                             std::vector<Weight>&& distances_from, std::vector<Weight>&& distances_to)
+    : vertex_count_(vertex_count)
+    , vertices_(std::move(vertices))
+    , distances_from_(std::move(distances_from))
+    , distances_to_(std::move(distances_to))
+{
+    if (distances_from_.size() != vertex_count_ * vertices_.size() || distances_to_.size() != vertex_count_ * vertices_.size()) {
+        throw std::invalid_argument("Landmarks: table size doesn't match vertex count");
+    }
+}
+
+template <typename Weight>
+Weight Landmarks<Weight>::GetLowerBound(VertexId from, VertexId to) const {
+    const size_t landmark_count = vertices_.size();
+    const Weight* landmarks_to_from = distances_from_.data() + from * landmark_count;
+    const Weight* landmarks_to_to = distances_from_.data() + to * landmark_count;
+    const Weight* from_to_landmarks = distances_to_.data() + from * landmark_count;
+    const Weight* to_to_landmarks = distances_to_.data() + to * landmark_count;
+
+    // Unreachable pairs give no bound; the differences are taken only when they are positive,
+    // so unsigned weights never wrap.
+    Weight bound = ZERO_WEIGHT;
+    for (size_t landmark = 0; landmark < landmark_count; ++landmark) {
+        if (landmarks_to_to[landmark] != INFINITE_WEIGHT && landmarks_to_from[landmark] < landmarks_to_to[landmark]) {
+            bound = std::max<Weight>(bound, landmarks_to_to[landmark] - landmarks_to_from[landmark]);
+        }
+        if (from_to_landmarks[landmark] != INFINITE_WEIGHT && to_to_landmarks[landmark] < from_to_landmarks[landmark]) {
+            bound = std::max<Weight>(bound, from_to_landmarks[landmark] - to_to_landmarks[landmark]);
+        }
+    }
+    return bound;
+}
+
+template <typename Weight>
+std::vector<Weight> Landmarks<Weight>::ComputeDistances(const Graph& graph, VertexId source, bool backward) {
+    using QueueEntry = std::pair<Weight, VertexId>;
+    std::vector<Weight> distances(graph.GetVertexCount(), INFINITE_WEIGHT);
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<>> queue;
+    distances[source] = ZERO_WEIGHT;
+    queue.push({ZERO_WEIGHT, source});
+
+    const auto relax = [&distances, &queue](VertexId vertex, Weight weight) {
+        if (weight < distances[vertex]) {
+            distances[vertex] = weight;
+            queue.push({weight, vertex});
+        }
+    };
+
+    while (!queue.empty()) {
+        const auto [distance, vertex] = queue.top();
+        queue.pop();
+        if (distance != distances[vertex]) {
+            continue;
+        }
+        if (backward) {
+            for (const EdgeId edge_id : graph.GetIncomingEdges(vertex)) {
+                const auto& edge = graph.GetEdge(edge_id);
+                relax(edge.from, distance + edge.weight);
+            }
+        } else {
+            for (size_t arc = graph.GetArcOffsets()[vertex]; arc < graph.GetArcOffsets()[vertex + 1]; ++arc) {
+                relax(graph.GetArcTargets()[arc], distance + graph.GetArcWeights()[arc]);
+            }
+        }
+    }
+    return distances;
+}
+
+template <typename Weight>
+void Landmarks<Weight>::StoreDistances(size_t landmark, const std::vector<Weight>& distances, std::vector<Weight>& table) const {
+    const size_t landmark_count = table.size() / std::max<size_t>(vertex_count_, 1);
+    for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+        table[vertex * landmark_count + landmark] = distances[vertex];
+    }
+}
+
+}  // namespace graph
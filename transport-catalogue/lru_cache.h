@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace cache {
+
+struct CacheStatistics {
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+// Bounded map evicting the least recently used entry. All methods lock a mutex,
+// so one cache can be shared between threads; Get returns a copy of the value.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    explicit LruCache(size_t capacity)
+        : capacity_(capacity) {
+    }
+
+    std::optional<Value> Get(const Key& key) {
+        std::optional<Value> output;
+        Visit(key, [&output](const Value& value) {
+            output = value;
+        });
+        return output;
+    }
+
+    // Calls visitor(value) under the lock instead of copying the value out; returns false on a miss.
+    template <typename Visitor>
+    bool Visit(const Key& key, Visitor&& visitor) {
+        std::lock_guard guard(mutex_);
+        const auto it = index_.find(key);
+        if (it == index_.end()) {
+            ++statistics_.misses;
+            return false;
+        }
+        ++statistics_.hits;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        visitor(static_cast<const Value&>(it->second->second));
+        return true;
+    }
+
+    void Put(const Key& key, Value value) {
+        if (capacity_ == 0) {
+            return;
+        }
+        std::lock_guard guard(mutex_);
+        if (const auto it = index_.find(key); it != index_.end()) {
+            it->second->second = std::move(value);
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+        entries_.emplace_front(key, std::move(value));
+        index_.emplace(key, entries_.begin());
+        if (entries_.size() > capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+    }
+
+    void Clear() {
+        std::lock_guard guard(mutex_);
+        index_.clear();
+        entries_.clear();
+    }
+
+    size_t GetCapacity() const {
+        return capacity_;
+    }
+
+    CacheStatistics GetStatistics() const {
+        std::lock_guard guard(mutex_);
+        return statistics_;
+    }
+
+private:
+    using Entries = std::list<std::pair<Key, Value>>;
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    Entries entries_;
+    std::unordered_map<Key, typename Entries::iterator, Hash> index_;
+    CacheStatistics statistics_;
+};
+
+}  // namespace cache
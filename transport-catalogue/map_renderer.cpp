@@ -10,28 +10,28 @@
 namespace catalogue_core {
 namespace renderer {
 
-void MapRenderer::RenderMap(const std::vector<domain::BusRoute*>& routes, std::ostream& os) const {
+void MapRenderer::RenderMap(const std::vector<domain::BusRoute*>& routes, const StopFinder& find_stop, std::ostream& os) const {
 
 	svg::Document doc;
 	std::vector<geo::Coordinates> for_sp;
 
 	for (const auto& route : routes) {
-		for (const auto& stop : route->stops) {
-			for_sp.push_back(stop->coordinates);
+		for (const domain::StopId stop : route->stops) {
+			for_sp.push_back(find_stop(stop)->coordinates);
 		}
 	}
 
 	SphereProjector sphere_projector(for_sp.begin(), for_sp.end(), renderer_settings_.width, renderer_settings_.height, renderer_settings_.padding);
 
-	std::set<domain::BusStop*, decltype(cmp)> stops_for_output(cmp);
+	std::set<const domain::BusStop*, decltype(cmp)> stops_for_output(cmp);
 	for (const auto route : routes) {
-		for (const auto& stop : route->stops) {
-			stops_for_output.insert(stop);
+		for (const domain::StopId stop : route->stops) {
+			stops_for_output.insert(find_stop(stop));
 		}
 	}
 
-	DrawLines(routes, doc, sphere_projector);
-	DrawRouteNames(routes, doc, sphere_projector);
+	DrawLines(routes, find_stop, doc, sphere_projector);
+	DrawRouteNames(routes, find_stop, doc, sphere_projector);
 	DrawStopSymbols(stops_for_output, doc, sphere_projector);
 	DrawStopNames(stops_for_output, doc, sphere_projector);
 		doc.Render(os);
@@ -56,7 +56,7 @@ void MapRenderer::CreateStopName(svg::Text& stop_name, svg::Document& doc) const
 	doc.AddPtr(std::make_unique<svg::Text>(stop_name));
 }
 
-void MapRenderer::DrawStopNames(const std::set<domain::BusStop*, decltype(cmp)>& stops_for_output, svg::Document& doc, const SphereProjector& sphere_projector) const {
+void MapRenderer::DrawStopNames(const std::set<const domain::BusStop*, decltype(cmp)>& stops_for_output, svg::Document& doc, const SphereProjector& sphere_projector) const {
 
 	svg::Text stop_name;
 
@@ -66,7 +66,7 @@ void MapRenderer::DrawStopNames(const std::set<domain::BusStop*, decltype(cmp)>&
 
 	for (const auto stop : stops_for_output) {
 		stop_name.SetPosition(sphere_projector(stop->coordinates));
-		stop_name.SetData(stop->name);
+		stop_name.SetData(std::string(stop->name));
 		CreateStopName(stop_name, doc);
 	}
 }
@@ -90,7 +90,7 @@ void MapRenderer::CreateRouteName(svg::Text& route_name, svg::Document& doc, svg
 	doc.AddPtr(std::make_unique<svg::Text>(route_name));
 }
 
-void MapRenderer::DrawStopSymbols(const std::set<domain::BusStop*, decltype(cmp)>& stops_for_output, svg::Document& doc, const SphereProjector& sphere_projector) const {
+void MapRenderer::DrawStopSymbols(const std::set<const domain::BusStop*, decltype(cmp)>& stops_for_output, svg::Document& doc, const SphereProjector& sphere_projector) const {
 
 	svg::Circle stop_symbol;
 
@@ -103,7 +103,7 @@ void MapRenderer::DrawStopSymbols(const std::set<domain::BusStop*, decltype(cmp)
 	}
 }
 
-void MapRenderer::DrawRouteNames(const std::vector<domain::BusRoute*>& routes, svg::Document& doc, const SphereProjector& sphere_projector) const {
+void MapRenderer::DrawRouteNames(const std::vector<domain::BusRoute*>& routes, const StopFinder& find_stop, svg::Document& doc, const SphereProjector& sphere_projector) const {
 
 	svg::Text route_name;
 
@@ -119,13 +119,13 @@ void MapRenderer::DrawRouteNames(const std::vector<domain::BusRoute*>& routes, s
 			continue;
 		}
 
-		route_name.SetData(route->name);
+		route_name.SetData(std::string(route->name));
 
-		route_name.SetPosition(sphere_projector((*route->stops.begin())->coordinates));
+		route_name.SetPosition(sphere_projector(find_stop(route->stops.front())->coordinates));
 		CreateRouteName(route_name, doc, renderer_settings_.color_palette[color_number]);
 
-		if ((route->circular == false) && ((*(route->stops.end() - 1))->coordinates != (*route->stops.begin())->coordinates)) {
-			route_name.SetPosition(sphere_projector((*(route->stops.end()-1))->coordinates));
+		if ((route->circular == false) && (find_stop(route->stops.back())->coordinates != find_stop(route->stops.front())->coordinates)) {
+			route_name.SetPosition(sphere_projector(find_stop(route->stops.back())->coordinates));
 			CreateRouteName(route_name, doc, renderer_settings_.color_palette[color_number]);
 		}
 
@@ -133,7 +133,7 @@ void MapRenderer::DrawRouteNames(const std::vector<domain::BusRoute*>& routes, s
 	}
 }
 
-void MapRenderer::DrawLines(const std::vector<domain::BusRoute*>& routes, svg::Document& doc, const SphereProjector& sphere_projector) const {
+void MapRenderer::DrawLines(const std::vector<domain::BusRoute*>& routes, const StopFinder& find_stop, svg::Document& doc, const SphereProjector& sphere_projector) const {
 
 	size_t color_number = 0;
 	for (const auto route : routes) {
@@ -141,14 +141,14 @@ void MapRenderer::DrawLines(const std::vector<domain::BusRoute*>& routes, svg::D
 			continue;
 		}
 		svg::Polyline route_curve;
-		for (const auto& stop : route->stops) {
-			route_curve.AddPoint(sphere_projector(stop->coordinates));
+		for (const domain::StopId stop : route->stops) {
+			route_curve.AddPoint(sphere_projector(find_stop(stop)->coordinates));
 		}
 		if ((route->circular == false) && (route->stops.size() > 1)) {
 			for (auto it = route->stops.end() - 2; it != route->stops.begin(); --it) {
-				route_curve.AddPoint(sphere_projector((*it)->coordinates));
+				route_curve.AddPoint(sphere_projector(find_stop(*it)->coordinates));
 			}
-			route_curve.AddPoint(sphere_projector((*route->stops.begin())->coordinates));
+			route_curve.AddPoint(sphere_projector(find_stop(route->stops.front())->coordinates));
 		}
 		route_curve.SetStrokeColor(renderer_settings_.color_palette[color_number])
 				   .SetStrokeWidth(renderer_settings_.line_width)
@@ -4,6 +4,8 @@
 #include <variant>
 #include <string>
 #include <algorithm>
+#include <functional>
+#include <set>
 
 #include "svg.h"
 #include "geo.h"
@@ -20,6 +22,10 @@ namespace renderer {
 
     inline constexpr auto cmp = [](const auto& lhs, const auto& rhs) {return lhs->name < rhs->name; };
 
+    // Buses keep the ids of their stops; the renderer gets the stops themselves through this,
+    // so it still does not depend on the catalogue.
+    using StopFinder = std::function<const domain::BusStop*(domain::StopId)>;
+
 	struct RendererSettings {
 
         RendererSettings() = default;
@@ -117,16 +123,16 @@ namespace renderer {
 
 	public:
 		MapRenderer() = default;
-        void RenderMap(const std::vector<domain::BusRoute*>& routes, std::ostream& os) const;
+        void RenderMap(const std::vector<domain::BusRoute*>& routes, const StopFinder& find_stop, std::ostream& os) const;
 		void LoadRendererSettings(RendererSettings&& renderer_settings);
         const RendererSettings& GetLoadRendererSettings() const;
 
 	private:
-        void DrawLines(const std::vector<domain::BusRoute*>& routes, svg::Document& doc, const SphereProjector& sphere_projector) const;
-        void DrawRouteNames(const std::vector<domain::BusRoute*>& routes, svg::Document& doc, const SphereProjector& sphere_projector) const;
+        void DrawLines(const std::vector<domain::BusRoute*>& routes, const StopFinder& find_stop, svg::Document& doc, const SphereProjector& sphere_projector) const;
+        void DrawRouteNames(const std::vector<domain::BusRoute*>& routes, const StopFinder& find_stop, svg::Document& doc, const SphereProjector& sphere_projector) const;
         void CreateRouteName(svg::Text& route_name, svg::Document& doc, svg::Color color) const;
-        void DrawStopSymbols(const std::set<domain::BusStop*, decltype(cmp)>& stops_for_output, svg::Document& doc, const SphereProjector& sphere_projector) const;
-        void DrawStopNames (const std::set<domain::BusStop*, decltype(cmp)>& stops_for_output, svg::Document& doc, const SphereProjector& sphere_projector) const;
+        void DrawStopSymbols(const std::set<const domain::BusStop*, decltype(cmp)>& stops_for_output, svg::Document& doc, const SphereProjector& sphere_projector) const;
+        void DrawStopNames (const std::set<const domain::BusStop*, decltype(cmp)>& stops_for_output, svg::Document& doc, const SphereProjector& sphere_projector) const;
         void CreateStopName(svg::Text& stop_name, svg::Document& doc) const;
 		RendererSettings renderer_settings_;
 
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+inline size_t GetThreadCount(size_t requested) {
+    if (requested != 0) {
+        return requested;
+    }
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+// Calls func(index) for every index in [0, count) on thread_count workers (0 - one per core).
+// Indices are handed out one by one, so uneven tasks are balanced between the workers.
+// The first exception thrown by func is rethrown in the calling thread.
+template <typename Func>
+void ForEachIndex(size_t count, size_t thread_count, Func&& func) {
+    thread_count = std::min(GetThreadCount(thread_count), count);
+    if (thread_count <= 1) {
+        for (size_t index = 0; index < count; ++index) {
+            func(index);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next_index = 0;
+    std::exception_ptr exception;
+    std::mutex exception_mutex;
+
+    auto worker = [&]() {
+        for (size_t index = next_index++; index < count; index = next_index++) {
+            try {
+                func(index);
+            }
+            catch (...) {
+                std::lock_guard guard(exception_mutex);
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+                next_index = count;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count - 1);
+    for (size_t i = 1; i < thread_count; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+}  // namespace parallel
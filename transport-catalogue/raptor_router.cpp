@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+#include "raptor_router.h"
+
+namespace catalogue_core {
+	namespace router {
+
+		namespace {
+			constexpr uint32_t NO_PATTERN = std::numeric_limits<uint32_t>::max();
+			constexpr uint32_t NO_LABEL = std::numeric_limits<uint32_t>::max();
+			constexpr double UNREACHED = std::numeric_limits<double>::infinity();
+		}
+
+		RaptorRouter::RaptorRouter(const transport_catalogue::TransportCatalogue& cat, int bus_wait_time, double minutes_per_meter)
+			: cat_(cat)
+			, bus_wait_time_(bus_wait_time)
+			, minutes_per_meter_(minutes_per_meter) {
+
+			for (const domain::BusStop* stop : cat.GetAllStops()) {
+				stop_to_index_[stop] = static_cast<uint32_t>(stops_.size());
+				stops_.push_back(stop);
+			}
+			stop_to_patterns_.resize(stops_.size());
+
+			for (const auto& route : cat.GetAllRoutes()) {
+				AddBusRoute(route);
+			}
+		}
+
+		void RaptorRouter::AddBusRoute(const domain::BusRoute* route) {
+			const domain::RouteDistances& route_distances = cat_.GetRouteDistances(route->id);
+			std::vector<uint32_t> stops;
+			stops.reserve(route->stops.size());
+
+			for (size_t i = 0; i < route->stops.size(); ++i) {
+				stops.push_back(stop_to_index_.at(cat_.FindBusStop(route->stops[i])));
+			}
+			AddPattern(route, std::move(stops), std::vector<int>(route_distances.road));
+
+			if (!route->circular) {
+				std::vector<uint32_t> reverse_stops;
+				std::vector<int> reverse_distances;
+				reverse_stops.reserve(route->stops.size());
+				reverse_distances.reserve(route->stops.size());
+
+				for (size_t i = route->stops.size(); i-- > 0;) {
+					reverse_stops.push_back(stop_to_index_.at(cat_.FindBusStop(route->stops[i])));
+					reverse_distances.push_back(route_distances.road_back.back() - route_distances.road_back[i]);
+				}
+				AddPattern(route, std::move(reverse_stops), std::move(reverse_distances));
+			}
+		}
+
+		// Going from the back, the last pattern is never one of the bus when it fills a freed place.
+		void RaptorRouter::RemoveBusRoute(const domain::BusRoute* route) {
+			for (auto pattern = static_cast<uint32_t>(patterns_.size()); pattern-- > 0;) {
+				if (patterns_[pattern].bus == route) {
+					RemovePattern(pattern);
+				}
+			}
+		}
+
+		// The last pattern takes the place of the removed one, so only the stops of the two are reindexed.
+		void RaptorRouter::RemovePattern(uint32_t pattern) {
+			for (const uint32_t stop : patterns_[pattern].stops) {
+				auto& stop_patterns = stop_to_patterns_[stop];
+				stop_patterns.erase(std::remove_if(stop_patterns.begin(), stop_patterns.end(), [pattern](const PatternStop& pattern_stop) {
+					return pattern_stop.pattern == pattern;
+				}), stop_patterns.end());
+			}
+
+			const auto last = static_cast<uint32_t>(patterns_.size() - 1);
+			if (pattern != last) {
+				for (const uint32_t stop : patterns_[last].stops) {
+					for (PatternStop& pattern_stop : stop_to_patterns_[stop]) {
+						if (pattern_stop.pattern == last) {
+							pattern_stop.pattern = pattern;
+						}
+					}
+				}
+				patterns_[pattern] = std::move(patterns_[last]);
+			}
+			patterns_.pop_back();
+		}
+
+		void RaptorRouter::AddPattern(const domain::BusRoute* bus, std::vector<uint32_t>&& stops, std::vector<int>&& distances) {
+			const auto pattern = static_cast<uint32_t>(patterns_.size());
+			for (size_t position = 0; position < stops.size(); ++position) {
+				stop_to_patterns_[stops[position]].push_back({ pattern, static_cast<uint32_t>(position) });
+			}
+			patterns_.push_back({ bus, std::move(stops), std::move(distances) });
+		}
+
+		double RaptorRouter::GetRideTime(const Pattern& pattern, uint32_t board_position, uint32_t alight_position) const {
+			return static_cast<double>(pattern.distances[alight_position] - pattern.distances[board_position]) * minutes_per_meter_;
+		}
+
+		void RaptorRouter::Search::Prepare(size_t stop_count, size_t pattern_count) {
+			if (best_labels.size() < stop_count) {
+				best_labels.resize(stop_count, NO_LABEL);
+				previous_labels.resize(stop_count, NO_LABEL);
+				marked.resize(stop_count, false);
+			}
+			if (first_marked_position.size() < pattern_count) {
+				first_marked_position.resize(pattern_count, NO_PATTERN);
+			}
+		}
+
+		void RaptorRouter::Search::Reach(uint32_t stop, const Label& label) {
+			if (best_labels[stop] == NO_LABEL) {
+				reached_stops.push_back(stop);
+			}
+			best_labels[stop] = static_cast<uint32_t>(labels.size());
+			labels.push_back(label);
+		}
+
+		void RaptorRouter::Search::Reset() {
+			for (const uint32_t stop : reached_stops) {
+				best_labels[stop] = NO_LABEL;
+				previous_labels[stop] = NO_LABEL;
+			}
+			reached_stops.clear();
+			labels.clear();
+		}
+
+		double RaptorRouter::Search::GetTime(uint32_t label) const {
+			return label == NO_LABEL ? UNREACHED : labels[label].time;
+		}
+
+		RaptorRouter::Search& RaptorRouter::GetSearch() {
+			static thread_local Search search;
+			return search;
+		}
+
+		void RaptorRouter::RunRounds(Search& search, uint32_t from, std::optional<uint32_t> to, double max_time) const {
+			const double wait_time = static_cast<double>(bus_wait_time_);
+
+			// best_labels[stop] - the fastest arrival with at most as many rides as the current round,
+			// previous_labels[stop] - with fewer rides. They differ only at the stops marked in the round,
+			// so a round costs the stops it improves, not all the stops.
+			search.Prepare(stops_.size(), patterns_.size());
+			search.Reach(from, { 0.0, NO_PATTERN, 0, 0, NO_LABEL });
+			search.previous_labels[from] = search.best_labels[from];
+
+			std::vector<bool>& marked = search.marked;
+			std::vector<uint32_t>& marked_stops = search.marked_stops;
+			std::vector<uint32_t>& first_marked_position = search.first_marked_position;
+			std::vector<uint32_t>& queued_patterns = search.queued_patterns;
+			std::vector<uint32_t>& previous_labels = search.previous_labels;
+			marked_stops.push_back(from);
+			marked[from] = true;
+
+			while (!marked_stops.empty()) {
+
+				for (const uint32_t stop : marked_stops) {
+					marked[stop] = false;
+					for (const auto& [pattern, position] : stop_to_patterns_[stop]) {
+						if (first_marked_position[pattern] == NO_PATTERN) {
+							queued_patterns.push_back(pattern);
+						}
+						first_marked_position[pattern] = std::min(first_marked_position[pattern], position);
+					}
+				}
+				marked_stops.clear();
+
+				for (const uint32_t pattern_index : queued_patterns) {
+					const Pattern& pattern = patterns_[pattern_index];
+					uint32_t board_position = NO_PATTERN;
+
+					for (uint32_t position = first_marked_position[pattern_index]; position < pattern.stops.size(); ++position) {
+						const uint32_t stop = pattern.stops[position];
+
+						if (board_position != NO_PATTERN) {
+							const uint32_t board_label = previous_labels[pattern.stops[board_position]];
+							const double arrival = search.GetTime(board_label) + wait_time + GetRideTime(pattern, board_position, position);
+							if (arrival < search.GetTime(search.best_labels[stop]) && arrival <= max_time
+								&& (!to.has_value() || arrival < search.GetTime(search.best_labels[*to]))) {
+								search.Reach(stop, { arrival, pattern_index, board_position, position, board_label });
+								if (!marked[stop]) {
+									marked[stop] = true;
+									marked_stops.push_back(stop);
+								}
+							}
+						}
+
+						const double previous_time = search.GetTime(previous_labels[stop]);
+						if (previous_time != UNREACHED
+							&& (board_position == NO_PATTERN
+								|| previous_time < search.GetTime(previous_labels[pattern.stops[board_position]]) + GetRideTime(pattern, board_position, position))) {
+							board_position = position;
+						}
+					}
+					first_marked_position[pattern_index] = NO_PATTERN;
+				}
+				queued_patterns.clear();
+
+				for (const uint32_t stop : marked_stops) {
+					previous_labels[stop] = search.best_labels[stop];
+				}
+			}
+		}
+
+		std::optional<RaptorRouter::Journey> RaptorRouter::BuildRoute(const domain::BusStop* start, const domain::BusStop* finish) const {
+
+			if ((stop_to_index_.count(start) == 0) || (stop_to_index_.count(finish) == 0)) {
+				return std::nullopt;
+			}
+			const uint32_t from = stop_to_index_.at(start);
+			const uint32_t to = stop_to_index_.at(finish);
+
+			Search& search = GetSearch();
+			RunRounds(search, from, to, UNREACHED);
+
+			if (search.best_labels[to] == NO_LABEL) {
+				search.Reset();
+				return std::nullopt;
+			}
+
+			Journey journey{ search.GetTime(search.best_labels[to]), {} };
+			for (uint32_t label_index = search.best_labels[to]; search.labels[label_index].pattern != NO_PATTERN;) {
+				const Label& label = search.labels[label_index];
+				const Pattern& pattern = patterns_[label.pattern];
+
+				journey.legs.push_back({ stops_[pattern.stops[label.board_position]],
+										 pattern.bus,
+										 static_cast<int>(label.alight_position - label.board_position),
+										 GetRideTime(pattern, label.board_position, label.alight_position) });
+				label_index = label.parent;
+			}
+			std::reverse(journey.legs.begin(), journey.legs.end());
+			search.Reset();
+
+			return journey;
+		}
+
+		std::optional<std::vector<std::pair<const domain::BusStop*, double>>> RaptorRouter::FindReachableStops(const domain::BusStop* start, double max_time) const {
+
+			if (stop_to_index_.count(start) == 0) {
+				return std::nullopt;
+			}
+			if (!(max_time >= 0.0)) {
+				return std::vector<std::pair<const domain::BusStop*, double>>{};
+			}
+
+			Search& search = GetSearch();
+			RunRounds(search, stop_to_index_.at(start), std::nullopt, max_time);
+
+			std::vector<std::pair<const domain::BusStop*, double>> output;
+			output.reserve(search.reached_stops.size());
+			for (const uint32_t stop : search.reached_stops) {
+				output.emplace_back(stops_[stop], search.GetTime(search.best_labels[stop]));
+			}
+			search.Reset();
+			std::sort(output.begin(), output.end(), [](const auto& lhs, const auto& rhs) {
+				return std::tie(lhs.second, lhs.first->name) < std::tie(rhs.second, rhs.first->name);
+			});
+
+			return output;
+		}
+	}
+}
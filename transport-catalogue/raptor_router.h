@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "domain.h"
+#include "transport_catalogue.h"
+
+namespace catalogue_core {
+	namespace router {
+
+		// Round-based router (RAPTOR) working directly on the stop sequences of the buses.
+		// Round k finds the fastest arrivals with exactly k rides, so no ride edges between
+		// every pair of stops of a bus are ever materialised.
+		class RaptorRouter {
+		public:
+			struct Leg {
+				const domain::BusStop* board_stop;
+				const domain::BusRoute* bus;
+				int span_count;
+				double bus_time;
+			};
+
+			struct Journey {
+				double total_time;
+				std::vector<Leg> legs;
+			};
+
+			explicit RaptorRouter(const transport_catalogue::TransportCatalogue& cat, int bus_wait_time, double minutes_per_meter);
+
+			std::optional<Journey> BuildRoute(const domain::BusStop* start, const domain::BusStop* finish) const;
+
+			// The stops of an added bus must be known to the router already.
+			void AddBusRoute(const domain::BusRoute* route);
+			void RemoveBusRoute(const domain::BusRoute* route);
+
+			// Stops reachable from start within max_time, with their arrival times in ascending order.
+			std::optional<std::vector<std::pair<const domain::BusStop*, double>>> FindReachableStops(const domain::BusStop* start, double max_time) const;
+
+		private:
+			// One direction of a bus: its stops and the road distances from the first stop.
+			struct Pattern {
+				const domain::BusRoute* bus;
+				std::vector<uint32_t> stops;
+				std::vector<int> distances;
+			};
+
+			struct PatternStop {
+				uint32_t pattern;
+				uint32_t position;
+			};
+
+			// Arrival at a stop; the ride that led to it is pattern[board_position..alight_position],
+			// boarded after the arrival "parent". The arrival at the start has no pattern.
+			struct Label {
+				double time;
+				uint32_t pattern;
+				uint32_t board_position;
+				uint32_t alight_position;
+				uint32_t parent;
+			};
+
+			// Every improvement of an arrival appends a label; best_labels[stop] is the last one of the stop.
+			// The buffers are kept between queries: a query resets only the stops it reached,
+			// and leaves no stop marked and no pattern queued behind.
+			struct Search {
+				std::vector<Label> labels;
+				std::vector<uint32_t> best_labels;
+				std::vector<uint32_t> previous_labels;
+				std::vector<uint32_t> reached_stops;
+
+				std::vector<bool> marked;
+				std::vector<uint32_t> marked_stops;
+				std::vector<uint32_t> first_marked_position;
+				std::vector<uint32_t> queued_patterns;
+
+				void Prepare(size_t stop_count, size_t pattern_count);
+				void Reach(uint32_t stop, const Label& label);
+				void Reset();
+				double GetTime(uint32_t label) const;
+			};
+
+			static Search& GetSearch();
+
+			void AddPattern(const domain::BusRoute* bus, std::vector<uint32_t>&& stops, std::vector<int>&& distances);
+			void RemovePattern(uint32_t pattern);
+			double GetRideTime(const Pattern& pattern, uint32_t board_position, uint32_t alight_position) const;
+
+			// Runs the rounds from "from" in search, which the caller resets. Arrivals later than max_time,
+			// or no earlier than the best arrival at "to" when it is given, are pruned.
+			void RunRounds(Search& search, uint32_t from, std::optional<uint32_t> to, double max_time) const;
+
+			const transport_catalogue::TransportCatalogue& cat_;
+			int bus_wait_time_;
+			double minutes_per_meter_;
+
+			std::vector<const domain::BusStop*> stops_;
+			std::unordered_map<const domain::BusStop*, uint32_t> stop_to_index_;
+			std::vector<Pattern> patterns_;
+			std::vector<std::vector<PatternStop>> stop_to_patterns_;
+		};
+	}
+}
@@ -1,6 +1,7 @@
 
 #include <iomanip>
 #include <iostream>
+#include <stdexcept>
 #include <unordered_set>
 
 #include "request_handler.h"
@@ -48,7 +49,13 @@ namespace catalogue_core {
         return answer;
     }
 
-    void RequestHandler::LoadBufferToCatalogue() {
+    void RequestHandler::LoadBufferToCatalogue(size_t thread_count) {
+
+        size_t length_count = 0;
+        for (const auto& bus_stop : bus_stop_buffer_) {
+            length_count += bus_stop.lengths.size();
+        }
+        catalogue_->Reserve(bus_stop_buffer_.size(), bus_route_buffer_.size(), length_count);
 
         for (auto it = bus_stop_buffer_.begin(); it != bus_stop_buffer_.end(); it++) {
             catalogue_->AddBusStop(it->bus_stop);
@@ -61,20 +68,55 @@ namespace catalogue_core {
         bus_stop_buffer_.clear();
 
         for (auto it = bus_route_buffer_.begin(); it != bus_route_buffer_.end(); it++) {
-            domain::BusRoute output;
-            output.circular = it->circular;
-            output.name = it->name;
+            catalogue_->AddBusRoute(ToBusRoute(*it));
+        }
+        bus_route_buffer_.clear();
 
-            output.stops.reserve(it->stops.size());
-            for (const auto& stop : it->stops) {
-                output.stops.push_back(catalogue_->FindBusStop(stop));
-            }
+        catalogue_->SetAllRoutes(thread_count);
+    }
 
-            catalogue_->AddBusRoute(output);
+    domain::BusRoute RequestHandler::ToBusRoute(const BusRouteRaw& bus_route) const {
+        domain::BusRoute output;
+        output.circular = bus_route.circular;
+        output.name = bus_route.name;
+
+        output.stops.reserve(bus_route.stops.size());
+        for (const auto& stop : bus_route.stops) {
+            const domain::BusStop* bus_stop = catalogue_->FindBusStop(stop);
+            if (bus_stop == nullptr) {
+                throw std::invalid_argument("ToBusRoute: Unknown bus stop name"s);
+            }
+            output.stops.push_back(bus_stop->id);
         }
-        bus_route_buffer_.clear();
+        return output;
+    }
 
+    void RequestHandler::AddBusRoute(const BusRouteRaw& bus_route) {
+        if (transport_router_ != nullptr && !transport_router_->SupportsBusUpdates()) {
+            throw std::logic_error("AddBusRoute: The routing engine doesn't take bus updates"s);
+        }
+        if (catalogue_->FindBusRoute(bus_route.name) != nullptr) {
+            throw std::invalid_argument("AddBusRoute: Bus route already exists"s);
+        }
+        const domain::BusRoute* route = catalogue_->AddBusRoute(ToBusRoute(bus_route));
         catalogue_->SetAllRoutes();
+        if (transport_router_ != nullptr) {
+            transport_router_->AddBusRoute(route);
+        }
+    }
+
+    void RequestHandler::RemoveBusRoute(const std::string& name) {
+        if (transport_router_ != nullptr && !transport_router_->SupportsBusUpdates()) {
+            throw std::logic_error("RemoveBusRoute: The routing engine doesn't take bus updates"s);
+        }
+        const domain::BusRoute* route = catalogue_->FindBusRoute(name);
+        if (route == nullptr) {
+            throw std::invalid_argument("RemoveBusRoute: Unknown bus route name"s);
+        }
+        if (transport_router_ != nullptr) {
+            transport_router_->RemoveBusRoute(route);
+        }
+        catalogue_->RemoveBusRoute(name);
     }
 
     void RequestHandler::AddStopsToBuffer(const BusStopRaw& bus_stop) {
@@ -86,7 +128,7 @@ namespace catalogue_core {
     }
 
     void RequestHandler::RenderMap(std::ostream& out) {
-        map_renderer_->RenderMap(catalogue_->GetAllRoutes(), out);
+        map_renderer_->RenderMap(catalogue_->GetAllRoutes(), [this](domain::StopId id) { return catalogue_->FindBusStop(id); }, out);
     }
 
     void RequestHandler::LoadRendererSettings(renderer::RendererSettings&& settings) {
@@ -102,6 +144,14 @@ namespace catalogue_core {
         return transport_router_->BuildFastestRoute(catalogue_->FindBusStop(from), catalogue_->FindBusStop(to));
     }
 
+    std::optional<double> RequestHandler::BuildFastestRoute(const std::string& from, const std::string& to, std::vector<router::RoutePart>& itinerary) {
+        return transport_router_->BuildFastestRoute(catalogue_->FindBusStop(from), catalogue_->FindBusStop(to), itinerary);
+    }
+
+    std::optional<std::vector<std::pair<const domain::BusStop*, double>>> RequestHandler::FindReachableStops(const std::string& from, double max_time) {
+        return transport_router_->FindReachableStops(catalogue_->FindBusStop(from), max_time);
+    }
+
     void RequestHandler::FillSerializeSettings(const std::string& filename) {
         serializator_.SetSettings(filename);
     }
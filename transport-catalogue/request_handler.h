@@ -61,7 +61,8 @@ namespace catalogue_core {
         explicit RequestHandler(transport_catalogue::TransportCatalogue& catalogue,
                                            renderer::MapRenderer& map_renderer_);
 
-        void LoadBufferToCatalogue();
+        // Bus distances and statistics are computed on thread_count threads (0 means one per core).
+        void LoadBufferToCatalogue(size_t thread_count = 1);
         Answer PrepareAnswerFromCatalogue(const QueryToBase& query) const;
         void AddStopsToBuffer(const BusStopRaw& bus_stop);
         void AddRoutesToBuffer(const BusRouteRaw& bus_route);
@@ -74,9 +75,19 @@ namespace catalogue_core {
 
         const std::vector<domain::BusRoute*> GetAllRoutes() const;
 
+        // Adds a bus to the catalogue and then to the router. Removal goes the other way round: the router
+        // finds the edges of the bus by its stops and distances, so the catalogue drops the bus only after.
+        // Nothing is changed when the routing engine doesn't take bus updates: std::logic_error is thrown.
+        void AddBusRoute(const BusRouteRaw& bus_route);
+        void RemoveBusRoute(const std::string& name);
+
         void CreateRouter(router::RouterSettings settings);
         std::optional<std::pair<std::vector<router::RoutePart>, double>> BuildFastestRoute(const std::string& from, const std::string& to);
+        std::optional<double> BuildFastestRoute(const std::string& from, const std::string& to, std::vector<router::RoutePart>& itinerary);
+        std::optional<std::vector<std::pair<const domain::BusStop*, double>>> FindReachableStops(const std::string& from, double max_time);
     private:     
+        domain::BusRoute ToBusRoute(const BusRouteRaw& bus_route) const;
+
         // RequestHandler использует агрегацию объектов "Транспортный Справочник" и "Визуализатор Карты"
          transport_catalogue::TransportCatalogue* catalogue_;
          renderer::MapRenderer* map_renderer_;
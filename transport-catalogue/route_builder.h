@@ -0,0 +1,35 @@
+#pragma once
+
+#include "graph.h"
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+template <typename Weight>
+class RouteBuilder {
+public:
+    struct RouteInfo {
+        Weight weight;
+        std::vector<EdgeId> edges;
+    };
+
+    // Writes the edges of the lightest route into "edges", reusing its capacity, and returns its weight.
+    // "edges" is cleared first and left empty when there is no route.
+    virtual std::optional<Weight> BuildRoute(VertexId from, VertexId to, std::vector<EdgeId>& edges) const = 0;
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const {
+        std::vector<EdgeId> edges;
+        const std::optional<Weight> weight = BuildRoute(from, to, edges);
+        if (!weight) {
+            return std::nullopt;
+        }
+        return RouteInfo{*weight, std::move(edges)};
+    }
+
+    virtual ~RouteBuilder() = default;
+};
+
+}  // namespace graph
@@ -1,43 +1,139 @@
 #pragma once
 
 #include "graph.h"
+#include "route_builder.h"
+#include "dijkstra_router.h"
+#include "floyd_warshall.h"
+#include "weight_traits.h"
+#include "parallel.h"
 
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <functional>
 #include <iterator>
+#include <limits>
+#include <mutex>
 #include <optional>
 #include <stdexcept>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
-#include "transport_router.h"
 
 namespace graph {
 
+// V x V table of the all-pairs Router stored as two row-major matrices:
+// 4-byte weights and 4-byte prev edges, 8 bytes per cell in one allocation each.
+// Unreachable cells hold an infinite weight and the UNREACHABLE prev edge,
+// the cell of a vertex to itself holds a zero weight and NO_EDGE.
+template <typename StoredWeight>
+class RoutesMatrix {
+public:
+    static constexpr uint32_t UNREACHABLE = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t NO_EDGE = UNREACHABLE - 1;
+    static constexpr StoredWeight INFINITE_WEIGHT = WeightTraits<StoredWeight>::INFINITE_WEIGHT;
+
+    RoutesMatrix() = default;
+
+    explicit RoutesMatrix(size_t vertex_count)
+        : vertex_count_(vertex_count)
+        , weights_(vertex_count * vertex_count, INFINITE_WEIGHT)
+        , prev_edges_(vertex_count * vertex_count, UNREACHABLE) {
+    }
+
+    explicit RoutesMatrix(size_t vertex_count, std::vector<StoredWeight>&& weights, std::vector<uint32_t>&& prev_edges)
+        : vertex_count_(vertex_count)
+        , weights_(std::move(weights))
+        , prev_edges_(std::move(prev_edges)) {
+        if (weights_.size() != vertex_count * vertex_count || prev_edges_.size() != vertex_count * vertex_count) {
+            throw std::invalid_argument("RoutesMatrix: table size doesn't match vertex count");
+        }
+    }
+
+    size_t GetVertexCount() const {
+        return vertex_count_;
+    }
+
+    bool IsReachable(VertexId from, VertexId to) const {
+        return prev_edges_[from * vertex_count_ + to] != UNREACHABLE;
+    }
+
+    StoredWeight GetWeight(VertexId from, VertexId to) const {
+        return weights_[from * vertex_count_ + to];
+    }
+
+    // Only meaningful for reachable cells: empty for the route of a vertex to itself.
+    std::optional<EdgeId> GetPrevEdge(VertexId from, VertexId to) const {
+        const uint32_t prev_edge = prev_edges_[from * vertex_count_ + to];
+        return prev_edge == NO_EDGE ? std::nullopt : std::optional<EdgeId>(prev_edge);
+    }
+
+    void Set(VertexId from, VertexId to, StoredWeight weight, std::optional<EdgeId> prev_edge) {
+        weights_[from * vertex_count_ + to] = weight;
+        prev_edges_[from * vertex_count_ + to] = prev_edge ? static_cast<uint32_t>(*prev_edge) : NO_EDGE;
+    }
+
+    void ClearRow(VertexId from) {
+        std::fill_n(weights_.begin() + from * vertex_count_, vertex_count_, INFINITE_WEIGHT);
+        std::fill_n(prev_edges_.begin() + from * vertex_count_, vertex_count_, UNREACHABLE);
+    }
+
+    StoredWeight* GetWeightsRow(VertexId from) {
+        return weights_.data() + from * vertex_count_;
+    }
+
+    uint32_t* GetPrevEdgesRow(VertexId from) {
+        return prev_edges_.data() + from * vertex_count_;
+    }
+
+    const std::vector<StoredWeight>& GetWeights() const {
+        return weights_;
+    }
+
+    const std::vector<uint32_t>& GetPrevEdges() const {
+        return prev_edges_;
+    }
+
+private:
+    size_t vertex_count_ = 0;
+    std::vector<StoredWeight> weights_;
+    std::vector<uint32_t> prev_edges_;
+};
+
 template <typename Weight>
-class Router {
+class Router final : public RouteBuilder<Weight> {
 
 private:
     using Graph = DirectedWeightedGraph<Weight>;
 
 public:
-    explicit Router(const Graph& graph);
-
+    using RouteInfo = typename RouteBuilder<Weight>::RouteInfo;
 
-    struct RouteInfo {
-        Weight weight;
-        std::vector<EdgeId> edges;
+    // Parallel alternative to Floyd-Warshall: every row of the table is filled by its own
+    // Dijkstra search. progress(rows_done, rows_total) is called after each row, one call at a time.
+    struct ParallelBuild {
+        size_t thread_count = 0;
+        std::function<void(size_t, size_t)> progress;
     };
 
-    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+    explicit Router(const Graph& graph);
+    explicit Router(const Graph& graph, const ParallelBuild& parallel_build);
 
-    struct RouteInternalData {
-        Weight weight;
-        std::optional<EdgeId> prev_edge;
-    };
+    using RouteBuilder<Weight>::BuildRoute;
+    std::optional<Weight> BuildRoute(VertexId from, VertexId to, std::vector<EdgeId>& edges) const override;
 
-    using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
+    // Repairs the table after the graph was thawed, changed and frozen again: only the rows whose
+    // routes went through a removed edge or may be shortened by an added one are searched anew.
+    // Returns the number of repaired rows.
+    size_t UpdateRoutes(const std::vector<EdgeId>& removed_edges, const std::vector<EdgeId>& added_edges, size_t thread_count = 0);
+
+    // Floating-point tables are kept in single precision: the weights only order the candidates,
+    // the weight of a built route is summed up again from its edges. Fixed-point tables keep their type.
+    using StoredWeight = std::conditional_t<std::is_floating_point_v<Weight>, float, Weight>;
+    using RoutesInternalData = RoutesMatrix<StoredWeight>;
+    static_assert(std::is_same_v<StoredWeight, float> || std::is_same_v<StoredWeight, uint32_t>,
+                  "FloydWarshall only has kernels for float and uint32_t tables");
 
   const  Router<Weight>::RoutesInternalData& GetRouteInternalData() const;
 
@@ -48,43 +144,21 @@ private:
     void InitializeRoutesInternalData(const Graph& graph) {
         const size_t vertex_count = graph.GetVertexCount();
         for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
-            routes_internal_data_[vertex][vertex] = RouteInternalData{ZERO_WEIGHT, std::nullopt};
+            routes_internal_data_.Set(vertex, vertex, ZERO_WEIGHT, std::nullopt);
             for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
                 const auto& edge = graph.GetEdge(edge_id);
-                if (edge.weight < ZERO_WEIGHT) {
+                if (edge.weight < Weight{}) {
                     throw std::domain_error("Edges' weights should be non-negative");
                 }
-                auto& route_internal_data = routes_internal_data_[vertex][edge.to];
-                if (!route_internal_data || route_internal_data->weight > edge.weight) {
-                    route_internal_data = RouteInternalData{edge.weight, edge_id};
-                }
-            }
-        }
-    }
-
-    void RelaxRoute(VertexId vertex_from, VertexId vertex_to, const RouteInternalData& route_from,
-                    const RouteInternalData& route_to) {
-        auto& route_relaxing = routes_internal_data_[vertex_from][vertex_to];
-        const Weight candidate_weight = route_from.weight + route_to.weight;
-        if (!route_relaxing || candidate_weight < route_relaxing->weight) {
-            route_relaxing = {candidate_weight,
-                              route_to.prev_edge ? route_to.prev_edge : route_from.prev_edge};
-        }
-    }
-
-    void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
-        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
-            if (const auto& route_from = routes_internal_data_[vertex_from][vertex_through]) {
-                for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
-                    if (const auto& route_to = routes_internal_data_[vertex_through][vertex_to]) {
-                        RelaxRoute(vertex_from, vertex_to, *route_from, *route_to);
-                    }
+                const auto weight = static_cast<StoredWeight>(edge.weight);
+                if (!routes_internal_data_.IsReachable(vertex, edge.to) || routes_internal_data_.GetWeight(vertex, edge.to) > weight) {
+                    routes_internal_data_.Set(vertex, edge.to, weight, edge_id);
                 }
             }
         }
     }
 
-    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr StoredWeight ZERO_WEIGHT{};
     const Graph& graph_;
     RoutesInternalData routes_internal_data_;
 };
@@ -92,45 +166,126 @@ private:
 template <typename Weight>
 Router<Weight>::Router(const Graph& graph)
     : graph_(graph)
-    , routes_internal_data_(graph.GetVertexCount(),
-                            std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
+    , routes_internal_data_(graph.GetVertexCount())
 {
+    if (graph.GetEdgeCount() >= RoutesInternalData::NO_EDGE) {
+        throw std::length_error("Too many edges for the routes table");
+    }
     InitializeRoutesInternalData(graph);
 
     const size_t vertex_count = graph.GetVertexCount();
-    for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
-        RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
+    if (vertex_count != 0) {
+        FloydWarshall(vertex_count, routes_internal_data_.GetWeightsRow(0), routes_internal_data_.GetPrevEdgesRow(0));
     }
 }
 
+template <typename Weight>
+Router<Weight>::Router(const Graph& graph, const ParallelBuild& parallel_build)
+    : graph_(graph)
+    , routes_internal_data_(graph.GetVertexCount())
+{
+    if (graph.GetEdgeCount() >= RoutesInternalData::NO_EDGE) {
+        throw std::length_error("Too many edges for the routes table");
+    }
+    const DijkstraRouter<Weight> dijkstra_router(graph);
+    const size_t vertex_count = graph.GetVertexCount();
+    size_t rows_done = 0;
+    std::mutex progress_mutex;
+
+    parallel::ForEachIndex(vertex_count, parallel_build.thread_count, [&](VertexId vertex_from) {
+        dijkstra_router.ForEachReachable(vertex_from, [this, vertex_from](VertexId vertex_to, Weight weight,
+                                                                         std::optional<EdgeId> prev_edge) {
+            routes_internal_data_.Set(vertex_from, vertex_to, static_cast<StoredWeight>(weight), prev_edge);
+        });
+        if (parallel_build.progress) {
+            std::lock_guard guard(progress_mutex);
+            parallel_build.progress(++rows_done, vertex_count);
+        }
+    });
+}
+
 template <typename Weight>
 Router<Weight>::Router(const Graph& graph, Router<Weight>::RoutesInternalData&& routes_internal_data) 
                         : graph_(graph)
                         , routes_internal_data_(std::move(routes_internal_data)){
+    if (routes_internal_data_.GetVertexCount() != graph.GetVertexCount()) {
+        throw std::invalid_argument("Routes table doesn't match the graph");
+    }
 }
 
 template <typename Weight>
-std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
-                                                                             VertexId to) const {
-    const auto& route_internal_data = routes_internal_data_.at(from).at(to);
-    if (!route_internal_data) {
+std::optional<Weight> Router<Weight>::BuildRoute(VertexId from, VertexId to, std::vector<EdgeId>& edges) const {
+    if (from >= routes_internal_data_.GetVertexCount() || to >= routes_internal_data_.GetVertexCount()) {
+        throw std::out_of_range("Router: unknown vertex");
+    }
+    edges.clear();
+    if (!routes_internal_data_.IsReachable(from, to)) {
         return std::nullopt;
     }
-    const Weight weight = route_internal_data->weight;
-    std::vector<EdgeId> edges;
-    for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
+    Weight weight{};
+    for (std::optional<EdgeId> edge_id = routes_internal_data_.GetPrevEdge(from, to);
          edge_id;
-         edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge)
+         edge_id = routes_internal_data_.GetPrevEdge(from, graph_.GetEdge(*edge_id).from))
     {
         edges.push_back(*edge_id);
     }
     std::reverse(edges.begin(), edges.end());
+    for (const EdgeId edge_id : edges) {
+        weight += graph_.GetEdge(edge_id).weight;
+    }
 
-    return RouteInfo{weight, std::move(edges)};
+    return weight;
 }
+
+template <typename Weight>
+size_t Router<Weight>::UpdateRoutes(const std::vector<EdgeId>& removed_edges, const std::vector<EdgeId>& added_edges,
+                                    size_t thread_count) {
+    if (graph_.GetEdgeCount() >= RoutesInternalData::NO_EDGE) {
+        throw std::length_error("Too many edges for the routes table");
+    }
+    const size_t vertex_count = graph_.GetVertexCount();
+    std::vector<bool> is_removed(graph_.GetEdgeCount(), false);
+    for (const EdgeId edge_id : removed_edges) {
+        is_removed[edge_id] = true;
+    }
+
+    std::vector<VertexId> affected_rows;
+    for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
+        const uint32_t* prev_edges = routes_internal_data_.GetPrevEdgesRow(vertex_from);
+        bool affected = std::any_of(prev_edges, prev_edges + vertex_count, [&is_removed](uint32_t prev_edge) {
+            return prev_edge < is_removed.size() && is_removed[prev_edge];
+        });
+        for (size_t i = 0; !affected && i < added_edges.size(); ++i) {
+            const auto& edge = graph_.GetEdge(added_edges[i]);
+            if (graph_.IsRemoved(added_edges[i]) || !routes_internal_data_.IsReachable(vertex_from, edge.from)) {
+                continue;
+            }
+            const StoredWeight candidate_weight = routes_internal_data_.GetWeight(vertex_from, edge.from)
+                                                  + static_cast<StoredWeight>(edge.weight);
+            affected = !routes_internal_data_.IsReachable(vertex_from, edge.to)
+                       || candidate_weight <= routes_internal_data_.GetWeight(vertex_from, edge.to);
+        }
+        if (affected) {
+            affected_rows.push_back(vertex_from);
+        }
+    }
+
+    const DijkstraRouter<Weight> dijkstra_router(graph_);
+    parallel::ForEachIndex(affected_rows.size(), thread_count, [&](size_t index) {
+        const VertexId vertex_from = affected_rows[index];
+        routes_internal_data_.ClearRow(vertex_from);
+        dijkstra_router.ForEachReachable(vertex_from, [this, vertex_from](VertexId vertex_to, Weight weight,
+                                                                         std::optional<EdgeId> prev_edge) {
+            routes_internal_data_.Set(vertex_from, vertex_to, static_cast<StoredWeight>(weight), prev_edge);
+        });
+    });
+
+    return affected_rows.size();
+}
+
 template <typename Weight>
  const typename Router<Weight>::RoutesInternalData& Router<Weight>::GetRouteInternalData() const {
     return routes_internal_data_;
 }
 
-}  // namespace graph
\ No newline at end of file
+}  // namespace graph
@@ -1,9 +1,11 @@
 #include "serialization.h"
 #include <algorithm>
+#include <type_traits>
 
 namespace serializator {
 
 	using NameToId = std::unordered_map<std::string_view, uint32_t>;
+	using RouteWeight = catalogue_core::router::RouteWeight;
 
 	void SerializeColor(const svg::Color& color, transport_serialize::Color& proto) {
 		if (std::holds_alternative<std::monostate>(color)) {
@@ -60,18 +62,20 @@ namespace serializator {
 		NameToId busname_to_ids;
 
 		transport_serialize::Catalogue serialize_catalogue;
+		// Stops go in the order of their ids, so the loaded catalogue gives them the same ids and lists them the same way.
 		unsigned int i = 0;
-		for (const auto& catalogue_stop : catalogue_->GetAllStops()) {
+		for (; i < catalogue_->GetNumStops(); ++i) {
+			const domain::BusStop& catalogue_stop = *catalogue_->FindBusStop(static_cast<domain::StopId>(i));
 
 			transport_serialize::BusStop  serialize_stop;
 
-			serialize_stop.set_name(catalogue_stop->name);
-			serialize_stop.mutable_coordinates()->set_lat(catalogue_stop->coordinates.lat);
-			serialize_stop.mutable_coordinates()->set_lng(catalogue_stop->coordinates.lng);
+			serialize_stop.set_name(std::string(catalogue_stop.name));
+			serialize_stop.mutable_coordinates()->set_lat(catalogue_stop.coordinates.lat);
+			serialize_stop.mutable_coordinates()->set_lng(catalogue_stop.coordinates.lng);
 
 			serialize_catalogue.mutable_stops()->Add(std::move(serialize_stop));
 
-			stopname_to_ids[catalogue_stop->name] = i++;
+			stopname_to_ids[catalogue_stop.name] = i;
 		}
 
 		i = 0;
@@ -81,34 +85,44 @@ namespace serializator {
 
 			serialize_route.set_circular(catalogue_bus->circular);
 
-			serialize_route.set_name(catalogue_bus->name);
+			serialize_route.set_name(std::string(catalogue_bus->name));
 			busname_to_ids[catalogue_bus->name] = i++;
 
-			for (const auto& catalogue_stop : catalogue_bus->stops) {
-				serialize_route.mutable_num_stops()->Add(stopname_to_ids.at(catalogue_stop->name));
+			for (const domain::StopId catalogue_stop : catalogue_bus->stops) {
+				serialize_route.mutable_num_stops()->Add(stopname_to_ids.at(catalogue_->FindBusStop(catalogue_stop)->name));
+			}
+
+			if (const auto statistic = catalogue_->GetInformationAboutBusRoute(catalogue_bus->id); statistic.has_value()) {
+				transport_serialize::RouteStatistic* serialize_statistic = serialize_route.mutable_statistic();
+				serialize_statistic->set_stop_count(statistic->num_of_stops_);
+				serialize_statistic->set_unique_stop_count(statistic->num_of_unique_stops_);
+				serialize_statistic->set_route_length(statistic->route_length_);
+				serialize_statistic->set_curvature(statistic->curvature);
 			}
 
 			serialize_catalogue.mutable_buses()->Add(std::move(serialize_route));
 		}
 
-		for (const auto& [pair_stops, len] : catalogue_->GetAllLengths()) {
+		catalogue_->GetAllLengths().ForEach([catalogue_, &stopname_to_ids, &serialize_catalogue](domain::StopId first_stop, domain::StopId second_stop, int len) {
 
 			transport_serialize::Length serialize_length;
 
-			serialize_length.set_first_stop(stopname_to_ids.at(pair_stops.first->name));
-			serialize_length.set_second_stop(stopname_to_ids.at(pair_stops.second->name));
+			serialize_length.set_first_stop(stopname_to_ids.at(catalogue_->FindBusStop(first_stop)->name));
+			serialize_length.set_second_stop(stopname_to_ids.at(catalogue_->FindBusStop(second_stop)->name));
 			serialize_length.set_length(len);
 
 			serialize_catalogue.mutable_lengths()->Add(std::move(serialize_length));
-		}
+		});
 		return { serialize_catalogue, stopname_to_ids, busname_to_ids };
 	}
 
-	std::pair<std::vector<domain::BusStop*>, std::vector<domain::BusRoute*>> Serialization::DeserializeCatalogue(catalogue_core::transport_catalogue::TransportCatalogue* catalogue_, transport_serialize::Catalogue& serialize_catalogue) {
+	std::pair<std::vector<domain::BusStop*>, std::vector<domain::BusRoute*>> Serialization::DeserializeCatalogue(catalogue_core::transport_catalogue::TransportCatalogue* catalogue_, transport_serialize::Catalogue& serialize_catalogue, size_t thread_count) {
 
 		std::vector<domain::BusStop*> stopnum_to_ptr(serialize_catalogue.stops().size());
 		std::vector<domain::BusRoute*> busnum_to_ptr(serialize_catalogue.buses().size());
 
+		catalogue_->Reserve(stopnum_to_ptr.size(), busnum_to_ptr.size(), serialize_catalogue.lengths().size());
+
 		size_t i = 0;
 		for (const auto& stop : serialize_catalogue.stops()) {
 			domain::BusStop bus_stop;
@@ -117,6 +131,10 @@ namespace serializator {
 			bus_stop.coordinates.lng = stop.coordinates().lng();
 			stopnum_to_ptr[i++] = catalogue_->AddBusStop(std::move(bus_stop));
 		}
+		// Lengths go in before the buses, so adding them has no bus to invalidate.
+		for (const auto& length : serialize_catalogue.lengths()) {
+			catalogue_->AddLengthByPtr(stopnum_to_ptr[length.first_stop()], stopnum_to_ptr[length.second_stop()], length.length());
+		}
 		i = 0;
 		for (const auto& bus : serialize_catalogue.buses()) {
 			domain::BusRoute bus_route;
@@ -124,16 +142,22 @@ namespace serializator {
 			bus_route.circular = bus.circular();
 
 			for (const auto& stop : bus.num_stops()) {
-				bus_route.stops.push_back(stopnum_to_ptr[stop]);
+				bus_route.stops.push_back(stopnum_to_ptr[stop]->id);
 			}
 
-			busnum_to_ptr[i++] = catalogue_->AddBusRoute(std::move(bus_route));
-		}
-
-		for (const auto length : serialize_catalogue.lengths()) {
-			catalogue_->AddLengthByPtr(stopnum_to_ptr[length.first_stop()], stopnum_to_ptr[length.second_stop()], length.length());
+			busnum_to_ptr[i] = catalogue_->AddBusRoute(std::move(bus_route));
+			if (bus.has_statistic()) {
+				catalogue_->SetRouteStatistic(busnum_to_ptr[i]->id, { static_cast<int>(bus.statistic().stop_count()),
+																	   static_cast<int>(bus.statistic().unique_stop_count()),
+																	   static_cast<int>(bus.statistic().route_length()),
+																	   bus.statistic().curvature() });
+			}
+			++i;
 		}
-		catalogue_->SetAllRoutes();
+		// Distances along the buses are not stored: rebuilding them takes two length lookups per stop
+		// of a bus and no great-circle distances, as the statistics above are kept, so it costs about
+		// what reading them back would and keeps the base smaller.
+		catalogue_->SetAllRoutes(thread_count);
 		return { stopnum_to_ptr, busnum_to_ptr };
 	}
 
@@ -205,42 +229,45 @@ namespace serializator {
 			map_renderer_->LoadRendererSettings(std::move(catalog_map_settings));
 	}
 
-	void SerializeGraphEdges(const graph::DirectedWeightedGraph<double>& graph, transport_serialize::Graph* ser_graph) {
-
-		ser_graph->mutable_edges()->Reserve(static_cast<int>(graph.GetEdgeCount()));
-		for (size_t i = 0; i < graph.GetEdgeCount(); ++i) {
-
-			auto cat_edge = graph.GetEdge(i);
-			transport_serialize::Edge ser_edge;
-
-			ser_edge.set_from(static_cast<uint32_t>(cat_edge.from));
-			ser_edge.set_to(static_cast<uint32_t>(cat_edge.to));
-			ser_edge.set_weight(cat_edge.weight);
-
-			ser_graph->mutable_edges()->Add(std::move(ser_edge));
+	// Weights go to the field of their own type, so fixed-point ones never round-trip through double.
+	template <typename Weights>
+	void SerializeWeights(const Weights& weights, google::protobuf::RepeatedField<double>* double_weights,
+						  google::protobuf::RepeatedField<uint32_t>* fixed_point_weights) {
+		if constexpr (std::is_integral_v<RouteWeight>) {
+			fixed_point_weights->Add(weights.begin(), weights.end());
+		}
+		else {
+			double_weights->Add(weights.begin(), weights.end());
 		}
 	}
-	
-	void SerializeGraphIncidenceLists(const graph::DirectedWeightedGraph<double>& graph, transport_serialize::Graph* ser_graph) {
-
-		ser_graph->mutable_incidence_lists()->Reserve(static_cast<int>(graph.GetVertexCount()));
-		for (size_t i = 0; i < graph.GetVertexCount(); ++i) {
 
-			transport_serialize::IncidenceList ser_incident_list;
-			const auto range = graph.GetIncidentEdges(i);
+	std::vector<RouteWeight> DeserializeWeights(const google::protobuf::RepeatedField<double>& double_weights,
+												const google::protobuf::RepeatedField<uint32_t>& fixed_point_weights) {
+		if constexpr (std::is_integral_v<RouteWeight>) {
+			return { fixed_point_weights.begin(), fixed_point_weights.end() };
+		}
+		else {
+			return { double_weights.begin(), double_weights.end() };
+		}
+	}
 
-			ser_incident_list.mutable_edge_ids()->Reserve(static_cast<int>(distance(range.begin(), range.end())));
-			for (auto it = range.begin(); it != range.end(); it++) {
-				ser_incident_list.mutable_edge_ids()->Add(*it);
-			}
+	void SerializeGraph(const graph::DirectedWeightedGraph<RouteWeight>& graph, transport_serialize::Graph* ser_graph) {
 
-			ser_graph->mutable_incidence_lists()->Add(std::move(ser_incident_list));
-		}
+		ser_graph->set_edge_count(static_cast<uint32_t>(graph.GetEdgeCount()));
+		ser_graph->mutable_arc_offsets()->Add(graph.GetArcOffsets().begin(), graph.GetArcOffsets().end());
+		ser_graph->mutable_arc_edges()->Add(graph.GetArcEdges().begin(), graph.GetArcEdges().end());
+		ser_graph->mutable_arc_targets()->Add(graph.GetArcTargets().begin(), graph.GetArcTargets().end());
+		SerializeWeights(graph.GetArcWeights(), ser_graph->mutable_arc_weights(), ser_graph->mutable_fixed_point_arc_weights());
 	}
-	
+
 	void SerializeRouterSettings(const catalogue_core::router::RouterSettings& cat_route_settings, transport_serialize::RouterSettings* ser_settings) {
 		ser_settings->set_bus_velocity(cat_route_settings.bus_velocity);
 		ser_settings->set_wait_time(cat_route_settings.bus_wait_time);
+		ser_settings->set_engine(cat_route_settings.engine);
+		ser_settings->set_fold_wait_edges(cat_route_settings.fold_wait_edges);
+		ser_settings->set_route_cache_size(static_cast<uint32_t>(cat_route_settings.route_cache_size));
+		ser_settings->set_landmark_count(static_cast<uint32_t>(cat_route_settings.landmark_count));
+		ser_settings->set_precompute_threads(static_cast<uint32_t>(cat_route_settings.precompute_threads));
 	}
 
 	void SerializeBusStopToVertex(const std::unordered_map<const domain::BusStop*, catalogue_core::router::Exchange>& cat_bus_stop_to_vertex,
@@ -259,63 +286,88 @@ namespace serializator {
 		}
 	}
 
-	void SerializeRouterData(const graph::Router<double>::RoutesInternalData& cat_router_data, 
-								  google::protobuf::RepeatedPtrField<transport_serialize::InternalDataIn>* ser_router_internal_data) {
-		
-		ser_router_internal_data->Reserve(cat_router_data.size());
-
-		for (const auto& cat_internal_vector : cat_router_data) {
-
-			transport_serialize::InternalDataIn ser_internal_data;
-			ser_internal_data.mutable_route_internal_data()->Reserve(cat_internal_vector.size());
-
-			for (const auto& data : cat_internal_vector) {
-				transport_serialize::RouteInternalData ser_route_internal_data;
-				if (data.has_value()) {
-					ser_route_internal_data.set_has_content(true);
-					ser_route_internal_data.set_weight(data.value().weight);
-
-					if (data.value().prev_edge.has_value()) {
-						ser_route_internal_data.mutable_edge_id()->set_has_content(true);
-						ser_route_internal_data.mutable_edge_id()->set_edge(data.value().prev_edge.value());
-					}
-					else {
-						ser_route_internal_data.mutable_edge_id()->set_has_content(false);
-					}
-				}
-				else {
-					ser_route_internal_data.set_has_content(false);
-				}
-				ser_internal_data.mutable_route_internal_data()->Add(std::move(ser_route_internal_data));
-			}
-			ser_router_internal_data->Add(std::move(ser_internal_data));
+	void SerializeRouterData(const graph::Router<RouteWeight>::RoutesInternalData& cat_router_data, 
+								  transport_serialize::RoutesInternalData* ser_router_internal_data) {
+
+		ser_router_internal_data->set_vertex_count(static_cast<uint32_t>(cat_router_data.GetVertexCount()));
+		if constexpr (std::is_integral_v<graph::Router<RouteWeight>::StoredWeight>) {
+			ser_router_internal_data->mutable_fixed_point_weights()->Add(cat_router_data.GetWeights().begin(), cat_router_data.GetWeights().end());
 		}
+		else {
+			ser_router_internal_data->mutable_weights()->Add(cat_router_data.GetWeights().begin(), cat_router_data.GetWeights().end());
+		}
+		ser_router_internal_data->mutable_prev_edges()->Add(cat_router_data.GetPrevEdges().begin(), cat_router_data.GetPrevEdges().end());
 	}
 	
-	void SetEdgesContent(const std::vector<catalogue_core::router::RoutePart> cat_edges_content, 
-								google::protobuf::RepeatedPtrField<transport_serialize::RouterPart>* ser_edges_content,
-						 const NameToId& busname_to_ids_,
-						 const NameToId& stopname_to_ids_) {
-
-		ser_edges_content->Reserve(cat_edges_content.size());
-
-		for (const auto& cat_edge : cat_edges_content) {
-			transport_serialize::RouterPart route_part;
-
-			route_part.set_wait_or_bus(cat_edge.wait_or_bus);
-			if (cat_edge.wait_or_bus == catalogue_core::router::WaitOrBus::WAIT) {
-				route_part.set_wait_time(cat_edge.wait_time);
-				route_part.set_stop_base_number(stopname_to_ids_.at(cat_edge.stop_name));
-				route_part.set_span_count(0);
-				route_part.set_bus_time(0);
+	void SerializeContractionHierarchy(const graph::ContractionHierarchy<RouteWeight>& cat_hierarchy,
+									   transport_serialize::ContractionHierarchy* ser_hierarchy) {
+
+		ser_hierarchy->mutable_ranks()->Add(cat_hierarchy.GetRanks().begin(), cat_hierarchy.GetRanks().end());
+
+		ser_hierarchy->mutable_shortcuts()->Reserve(static_cast<int>(cat_hierarchy.GetShortcuts().size()));
+		for (const auto& cat_shortcut : cat_hierarchy.GetShortcuts()) {
+			transport_serialize::Shortcut ser_shortcut;
+
+			ser_shortcut.set_from(static_cast<uint32_t>(cat_shortcut.from));
+			ser_shortcut.set_to(static_cast<uint32_t>(cat_shortcut.to));
+			if constexpr (std::is_integral_v<RouteWeight>) {
+				ser_shortcut.set_fixed_point_weight(cat_shortcut.weight);
 			}
 			else {
-				route_part.set_bus_time(cat_edge.bus_time);
-				route_part.set_bus_base_number(busname_to_ids_.at(cat_edge.bus_name));
-				route_part.set_span_count(cat_edge.span_count);
-				route_part.set_wait_time(0);
+				ser_shortcut.set_weight(cat_shortcut.weight);
+			}
+			ser_shortcut.set_first_edge(static_cast<uint32_t>(cat_shortcut.first_edge));
+			ser_shortcut.set_second_edge(static_cast<uint32_t>(cat_shortcut.second_edge));
+
+			ser_hierarchy->mutable_shortcuts()->Add(std::move(ser_shortcut));
+		}
+	}
+
+	void SerializeLandmarks(const graph::Landmarks<RouteWeight>& cat_landmarks, transport_serialize::Landmarks* ser_landmarks) {
+
+		ser_landmarks->mutable_vertices()->Add(cat_landmarks.GetVertices().begin(), cat_landmarks.GetVertices().end());
+		SerializeWeights(cat_landmarks.GetDistancesFrom(), ser_landmarks->mutable_distances_from(), ser_landmarks->mutable_fixed_point_distances_from());
+		SerializeWeights(cat_landmarks.GetDistancesTo(), ser_landmarks->mutable_distances_to(), ser_landmarks->mutable_fixed_point_distances_to());
+	}
+
+	void SerializeHubLabelSet(const graph::HubLabels<RouteWeight>::LabelSet& cat_labels, transport_serialize::HubLabelSet* ser_labels) {
+
+		ser_labels->mutable_offsets()->Add(cat_labels.offsets.begin(), cat_labels.offsets.end());
+		ser_labels->mutable_hubs()->Add(cat_labels.hubs.begin(), cat_labels.hubs.end());
+		SerializeWeights(cat_labels.distances, ser_labels->mutable_distances(), ser_labels->mutable_fixed_point_distances());
+		ser_labels->mutable_parent_edges()->Add(cat_labels.parent_edges.begin(), cat_labels.parent_edges.end());
+	}
+
+	void SerializeHubLabels(const graph::HubLabels<RouteWeight>& cat_hub_labels, transport_serialize::HubLabels* ser_hub_labels) {
+
+		ser_hub_labels->mutable_hub_vertices()->Add(cat_hub_labels.GetHubVertices().begin(), cat_hub_labels.GetHubVertices().end());
+		SerializeHubLabelSet(cat_hub_labels.GetOutLabels(), ser_hub_labels->mutable_out_labels());
+		SerializeHubLabelSet(cat_hub_labels.GetInLabels(), ser_hub_labels->mutable_in_labels());
+	}
+
+	void SetEdgesContent(const std::vector<catalogue_core::router::EdgeContent>& cat_edges_content,
+						 const std::vector<const domain::BusRoute*>& cat_buses,
+						 transport_serialize::RouterParts* ser_edges_content,
+						 const graph::DirectedWeightedGraph<RouteWeight>& graph,
+						 const NameToId& busname_to_ids_) {
+
+		ser_edges_content->mutable_buses()->Reserve(static_cast<int>(cat_edges_content.size()));
+		ser_edges_content->mutable_board_positions()->Reserve(static_cast<int>(cat_edges_content.size()));
+		ser_edges_content->mutable_alight_positions()->Reserve(static_cast<int>(cat_edges_content.size()));
+
+		for (size_t i = 0; i < cat_edges_content.size(); ++i) {
+			const auto& cat_edge = cat_edges_content[i];
+
+			// A removed edge may refer to a bus that is gone; its content is never read again.
+			if (graph.IsRemoved(i) || cat_edge.bus == catalogue_core::router::EdgeContent::NO_BUS) {
+				ser_edges_content->add_buses(0);
+				ser_edges_content->add_board_positions(0);
+				ser_edges_content->add_alight_positions(0);
+				continue;
 			}
-			ser_edges_content->Add(std::move(route_part));
+			ser_edges_content->add_buses(busname_to_ids_.at(cat_buses[cat_edge.bus]->name) + 1);
+			ser_edges_content->add_board_positions(cat_edge.board_position);
+			ser_edges_content->add_alight_positions(cat_edge.alight_position);
 		}
 	}
 
@@ -324,17 +376,26 @@ namespace serializator {
 													const NameToId& busname_to_ids_) {
 		transport_serialize::Router ser_router;
 	
-		SerializeGraphEdges(transport_router_->GetGraph(), ser_router.mutable_graph());
-
-		SerializeGraphIncidenceLists(transport_router_->GetGraph(), ser_router.mutable_graph());
+		SerializeGraph(transport_router_->GetGraph(), ser_router.mutable_graph());
 	
 		SerializeRouterSettings(transport_router_->GetRouterSettings(), ser_router.mutable_router_settings());
 
 		SerializeBusStopToVertex(transport_router_->GetBusstopToVertex(), ser_router.mutable_bus_stop_to_vertex(), stopname_to_ids_);
 
-		SerializeRouterData(transport_router_->GetRouterData(), ser_router.mutable_internal_data());
+		if (const auto router_data = transport_router_->GetRouterData(); router_data != nullptr) {
+			SerializeRouterData(*router_data, ser_router.mutable_routes_internal_data());
+		}
+		if (const auto hierarchy = transport_router_->GetContractionHierarchy(); hierarchy != nullptr) {
+			SerializeContractionHierarchy(*hierarchy, ser_router.mutable_contraction_hierarchy());
+		}
+		if (const auto landmarks = transport_router_->GetLandmarks(); landmarks != nullptr) {
+			SerializeLandmarks(*landmarks, ser_router.mutable_landmarks());
+		}
+		if (const auto hub_labels = transport_router_->GetHubLabels(); hub_labels != nullptr) {
+			SerializeHubLabels(*hub_labels, ser_router.mutable_hub_labels());
+		}
 		
-		SetEdgesContent(transport_router_->GetEdgesContent(), ser_router.mutable_edges_content(), busname_to_ids_, stopname_to_ids_);
+		SetEdgesContent(transport_router_->GetEdgesContent(), transport_router_->GetBuses(), ser_router.mutable_edges_content(), transport_router_->GetGraph(), busname_to_ids_);
 		
 		return ser_router;
 	}
@@ -344,64 +405,87 @@ namespace serializator {
 
 		output.bus_velocity = router_settings.bus_velocity();
 		output.bus_wait_time = router_settings.wait_time();
+		output.engine = static_cast<catalogue_core::router::RouterEngine>(router_settings.engine());
+		output.fold_wait_edges = router_settings.fold_wait_edges();
+		output.route_cache_size = router_settings.route_cache_size();
+		output.landmark_count = router_settings.landmark_count();
+		output.precompute_threads = router_settings.precompute_threads();
 
 		return output;
 	}
 
-	std::vector<graph::Edge<double>> DeserializeGraphEdges(const transport_serialize::Graph& graph) {
+	graph::DirectedWeightedGraph<RouteWeight> DeserializeGraph(const transport_serialize::Graph& graph) {
+
+		std::vector<size_t> arc_offsets(graph.arc_offsets().begin(), graph.arc_offsets().end());
+		std::vector<graph::EdgeId> arc_edges(graph.arc_edges().begin(), graph.arc_edges().end());
+		std::vector<graph::VertexId> arc_targets(graph.arc_targets().begin(), graph.arc_targets().end());
+		std::vector<RouteWeight> arc_weights(DeserializeWeights(graph.arc_weights(), graph.fixed_point_arc_weights()));
+
+		return graph::DirectedWeightedGraph<RouteWeight>(graph.edge_count(), std::move(arc_offsets), std::move(arc_edges), std::move(arc_targets), std::move(arc_weights));
+	}
+
+	graph::Router<RouteWeight>::RoutesInternalData DeserializeRouteInternalData(const transport_serialize::RoutesInternalData& internal_data) {
 
-		std::vector<graph::Edge<double>> output;
-		output.reserve(graph.edges().size());
-		for (auto it = graph.edges().begin(); it != graph.edges().end(); ++it) {
-			graph::Edge<double> edge;
-			edge.from = (*it).from();
-			edge.to = (*it).to();
-			edge.weight = (*it).weight();
-			output.push_back(std::move(edge));
+		std::vector<graph::Router<RouteWeight>::StoredWeight> weights;
+		if constexpr (std::is_integral_v<graph::Router<RouteWeight>::StoredWeight>) {
+			weights.assign(internal_data.fixed_point_weights().begin(), internal_data.fixed_point_weights().end());
 		}
-		return output;
+		else {
+			weights.assign(internal_data.weights().begin(), internal_data.weights().end());
+		}
+		std::vector<uint32_t> prev_edges(internal_data.prev_edges().begin(), internal_data.prev_edges().end());
+
+		return graph::Router<RouteWeight>::RoutesInternalData(internal_data.vertex_count(), std::move(weights), std::move(prev_edges));
 	}
 
-	std::vector<std::vector<graph::EdgeId>> DeserializeGraphIncidentList(const transport_serialize::Graph& graph) {
-		std::vector<std::vector<graph::EdgeId>> output  = { static_cast<unsigned int>(graph.incidence_lists_size()),
-																	std::vector<graph::EdgeId>() };
-		for (size_t i = 0; i < graph.incidence_lists_size(); ++i) {
-			output[i].resize(graph.incidence_lists().Get(i).edge_ids_size());
-			std::copy(graph.incidence_lists().Get(i).edge_ids().begin(),
-					  graph.incidence_lists().Get(i).edge_ids().end(),
-				output[i].begin());
+	std::unique_ptr<graph::ContractionHierarchy<RouteWeight>> DeserializeContractionHierarchy(const graph::DirectedWeightedGraph<RouteWeight>& graph,
+																						   const transport_serialize::ContractionHierarchy& ser_hierarchy) {
+
+		std::vector<uint32_t> ranks(ser_hierarchy.ranks().begin(), ser_hierarchy.ranks().end());
+
+		std::vector<graph::ContractionHierarchy<RouteWeight>::Shortcut> shortcuts;
+		shortcuts.reserve(ser_hierarchy.shortcuts_size());
+		for (const auto& ser_shortcut : ser_hierarchy.shortcuts()) {
+			shortcuts.push_back({ ser_shortcut.from(),
+								  ser_shortcut.to(),
+								  std::is_integral_v<RouteWeight> ? static_cast<RouteWeight>(ser_shortcut.fixed_point_weight())
+																  : static_cast<RouteWeight>(ser_shortcut.weight()),
+								  ser_shortcut.first_edge(),
+								  ser_shortcut.second_edge() });
 		}
-		return output;
+		return std::make_unique<graph::ContractionHierarchy<RouteWeight>>(graph, std::move(ranks), std::move(shortcuts));
 	}
 
-	graph::Router<double>::RoutesInternalData DeserializeRouteInternalData(const google::protobuf::RepeatedPtrField<transport_serialize::InternalDataIn>& internal_data) {
-		graph::Router<double>::RoutesInternalData  output = { static_cast<unsigned int>(internal_data.size()),
-																			std::vector<std::optional<graph::Router<double>::RouteInternalData>>() };
+	std::unique_ptr<graph::Landmarks<RouteWeight>> DeserializeLandmarks(size_t vertex_count, const transport_serialize::Landmarks& ser_landmarks) {
+
+		std::vector<graph::VertexId> vertices(ser_landmarks.vertices().begin(), ser_landmarks.vertices().end());
+		std::vector<RouteWeight> distances_from(DeserializeWeights(ser_landmarks.distances_from(), ser_landmarks.fixed_point_distances_from()));
+		std::vector<RouteWeight> distances_to(DeserializeWeights(ser_landmarks.distances_to(), ser_landmarks.fixed_point_distances_to()));
 
-		for (size_t i = 0; i < internal_data.size(); ++i) {
-			output[i].reserve(internal_data.Get(i).route_internal_data_size());
+		return std::make_unique<graph::Landmarks<RouteWeight>>(vertex_count, std::move(vertices), std::move(distances_from), std::move(distances_to));
+	}
 
-			auto temp = internal_data.Get(i).route_internal_data();
-			for (auto it = temp.begin(); it != temp.end(); ++it) {
+	graph::HubLabels<RouteWeight>::LabelSet DeserializeHubLabelSet(const transport_serialize::HubLabelSet& ser_labels) {
 
-				std::optional<graph::Router<double>::RouteInternalData> route_internal_data;
+		graph::HubLabels<RouteWeight>::LabelSet output;
+		output.offsets.assign(ser_labels.offsets().begin(), ser_labels.offsets().end());
+		output.hubs.assign(ser_labels.hubs().begin(), ser_labels.hubs().end());
+		output.distances = DeserializeWeights(ser_labels.distances(), ser_labels.fixed_point_distances());
+		output.parent_edges.assign(ser_labels.parent_edges().begin(), ser_labels.parent_edges().end());
 
-				if ((*it).has_content()) {
-					std::optional<graph::EdgeId> prev_edge;
-					if ((*it).edge_id().has_content()) {
-						prev_edge = (*it).edge_id().edge();
-					}
-					graph::Router<double>::RouteInternalData data;
-					data.weight = (*it).weight();
-					data.prev_edge = prev_edge;
-					route_internal_data = std::move(data);
-				}
-				output[i].push_back(std::move(route_internal_data));
-			}
-		}
 		return output;
 	}
 
+	std::unique_ptr<graph::HubLabels<RouteWeight>> DeserializeHubLabels(const graph::DirectedWeightedGraph<RouteWeight>& graph,
+																		  const transport_serialize::HubLabels& ser_hub_labels) {
+
+		std::vector<graph::VertexId> hub_vertices(ser_hub_labels.hub_vertices().begin(), ser_hub_labels.hub_vertices().end());
+
+		return std::make_unique<graph::HubLabels<RouteWeight>>(graph, std::move(hub_vertices),
+															   DeserializeHubLabelSet(ser_hub_labels.out_labels()),
+															   DeserializeHubLabelSet(ser_hub_labels.in_labels()));
+	}
+
 	std::unordered_map<const domain::BusStop*, catalogue_core::router::Exchange> DeserializeStopToVertex(const google::protobuf::RepeatedPtrField<transport_serialize::Exchange>& stop_to_vertex,
 																										 const std::vector<domain::BusStop*>& bus_stops ){
 		std::unordered_map<const domain::BusStop*, catalogue_core::router::Exchange> output;
@@ -417,27 +501,20 @@ namespace serializator {
 		return output;
 	}
 
-	std::vector<catalogue_core::router::RoutePart> DeserializeEdgesContent(const google::protobuf::RepeatedPtrField<transport_serialize::RouterPart>& edges_content,
-																		   const std::vector<domain::BusStop*>& bus_stops,
-																		   const std::vector<domain::BusRoute*>& bus_routes) {
+	std::vector<catalogue_core::router::EdgeContent> DeserializeEdgesContent(const transport_serialize::RouterParts& edges_content) {
 
-		std::vector<catalogue_core::router::RoutePart> output(edges_content.size());
+		if (edges_content.buses_size() != edges_content.board_positions_size() || edges_content.buses_size() != edges_content.alight_positions_size()) {
+			throw std::invalid_argument("DeserializeEdgesContent: Edge contents are inconsistent");
+		}
+		std::vector<catalogue_core::router::EdgeContent> output(edges_content.buses_size());
 
-		size_t i = 0;
-		for (const auto& edge : edges_content) {
-			catalogue_core::router::RoutePart route_part;
-			route_part.wait_or_bus = (edge.wait_or_bus() == 0) ? catalogue_core::router::WaitOrBus::WAIT :
-				catalogue_core::router::WaitOrBus::BUS;
-			if (route_part.wait_or_bus == catalogue_core::router::WaitOrBus::WAIT) {
-				route_part.wait_time = edge.wait_time();
-				route_part.stop_name = bus_stops[edge.stop_base_number()]->name;
+		for (int i = 0; i < edges_content.buses_size(); ++i) {
+			if (edges_content.buses(i) == 0) {
+				continue;
 			}
-			else {
-				route_part.bus_name = bus_routes[edge.bus_base_number()]->name;
-				route_part.bus_time = edge.bus_time();
-				route_part.span_count = edge.span_count();
-			}
-			output[i++] = std::move(route_part);
+			output[i] = { edges_content.buses(i) - 1,
+						  edges_content.board_positions(i),
+						  edges_content.alight_positions(i) };
 		}
 		return output;
 	}
@@ -450,25 +527,48 @@ namespace serializator {
 
 		catalogue_core::router::RouterSettings cat_router_settings(std::move(DeserializeRouterSettings(serialize_router.router_settings())));
 		
-		std::vector<graph::Edge<double>> graph_edges(std::move(DeserializeGraphEdges(serialize_router.graph())));
-
-		std::vector<std::vector<graph::EdgeId>> incidence_lists_(std::move(DeserializeGraphIncidentList(serialize_router.graph())));
-
-		graph::Router<double>::RoutesInternalData cat_routes_inter_data(std::move(DeserializeRouteInternalData(serialize_router.internal_data())));
-			
 		std::unordered_map<const domain::BusStop*, catalogue_core::router::Exchange> cat_bus_stop_to_vertex_(std::move(DeserializeStopToVertex(serialize_router.bus_stop_to_vertex(), bus_stops)));
 
-		std::vector<catalogue_core::router::RoutePart> edges_content(std::move(DeserializeEdgesContent(serialize_router.edges_content(), bus_stops, bus_routes)));
+		std::vector<catalogue_core::router::EdgeContent> edges_content(DeserializeEdgesContent(serialize_router.edges_content()));
 
-		graph::DirectedWeightedGraph<double> graph(std::move(graph_edges), std::move(incidence_lists_));
+		graph::DirectedWeightedGraph<RouteWeight> graph(DeserializeGraph(serialize_router.graph()));
 
 		transport_router_ = std::make_unique<catalogue_core::router::TransportRouter>(catalogue_,
 											std::move(cat_router_settings),
 											std::move(graph),
 											std::move(cat_bus_stop_to_vertex_),
+											std::vector<const domain::BusRoute*>(bus_routes.begin(), bus_routes.end()),
 											std::move(edges_content));
 
-		transport_router_->SetRouterLink(std::move(std::make_unique<graph::Router<double>>(transport_router_->GetGraphLink(), std::move(cat_routes_inter_data))));
+		switch (transport_router_->GetRouterSettings().engine) {
+		case catalogue_core::router::RouterEngine::DIJKSTRA:
+			transport_router_->SetRouterLink(std::make_unique<graph::DijkstraRouter<RouteWeight>>(transport_router_->GetGraphLink()));
+			break;
+		case catalogue_core::router::RouterEngine::BIDIRECTIONAL_DIJKSTRA:
+			transport_router_->SetRouterLink(std::make_unique<graph::BidirectionalDijkstraRouter<RouteWeight>>(transport_router_->GetGraphLink()));
+			break;
+		case catalogue_core::router::RouterEngine::A_STAR:
+			transport_router_->SetRouterLink(std::make_unique<graph::AStarRouter<RouteWeight>>(transport_router_->GetGraphLink(),
+																						  transport_router_->CreateGeoHeuristic()));
+			break;
+		case catalogue_core::router::RouterEngine::HUB_LABELS:
+			transport_router_->SetRouterLink(DeserializeHubLabels(transport_router_->GetGraphLink(), serialize_router.hub_labels()));
+			break;
+		case catalogue_core::router::RouterEngine::ALT:
+			transport_router_->SetLandmarks(DeserializeLandmarks(transport_router_->GetGraphLink().GetVertexCount(), serialize_router.landmarks()));
+			transport_router_->SetRouterLink(std::make_unique<graph::AStarRouter<RouteWeight>>(transport_router_->GetGraphLink(),
+																							   transport_router_->CreateLandmarkHeuristic()));
+			break;
+		case catalogue_core::router::RouterEngine::RAPTOR:
+			transport_router_->CreateRaptorRouter();
+			break;
+		case catalogue_core::router::RouterEngine::CONTRACTION_HIERARCHY:
+			transport_router_->SetRouterLink(DeserializeContractionHierarchy(transport_router_->GetGraphLink(), serialize_router.contraction_hierarchy()));
+			break;
+		default:
+			graph::Router<RouteWeight>::RoutesInternalData cat_routes_inter_data(std::move(DeserializeRouteInternalData(serialize_router.routes_internal_data())));
+			transport_router_->SetRouterLink(std::make_unique<graph::Router<RouteWeight>>(transport_router_->GetGraphLink(), std::move(cat_routes_inter_data)));
+		}
 	}
 
 	bool Serialization::SerializeFull(const catalogue_core::transport_catalogue::TransportCatalogue* catalogue_,
@@ -514,7 +614,7 @@ namespace serializator {
 
 				const auto catalogue_ptr = base.mutable_catalogue();
 				if (catalogue_ptr != nullptr) {
-					auto [stop_num_to_ptr, bus_num_to_ptr] = DeserializeCatalogue(catalogue_, *catalogue_ptr);
+					auto [stop_num_to_ptr, bus_num_to_ptr] = DeserializeCatalogue(catalogue_, *catalogue_ptr, base.router().router_settings().precompute_threads());
 
 					const auto router_ptr = base.mutable_router();
 					if (router_ptr != nullptr)
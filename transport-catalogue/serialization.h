@@ -32,7 +32,7 @@ namespace serializator {
 							 std::unique_ptr<catalogue_core::router::TransportRouter>& transport_router_);
 
 		std::tuple<transport_serialize::Catalogue, NameToId, NameToId>  SerializeCatalogue(const catalogue_core::transport_catalogue::TransportCatalogue* catalogue_);
-		std::pair<std::vector<domain::BusStop*>, std::vector<domain::BusRoute*>> DeserializeCatalogue(catalogue_core::transport_catalogue::TransportCatalogue* catalogue_, transport_serialize::Catalogue& serialize_catalogue);
+		std::pair<std::vector<domain::BusStop*>, std::vector<domain::BusRoute*>> DeserializeCatalogue(catalogue_core::transport_catalogue::TransportCatalogue* catalogue_, transport_serialize::Catalogue& serialize_catalogue, size_t thread_count);
 
 		transport_serialize::Settings SerializeMap(catalogue_core::renderer::MapRenderer* map_renderer_);
 		void DeserializeMap(catalogue_core::renderer::MapRenderer* map_renderer_, transport_serialize::Settings& serialize_map);
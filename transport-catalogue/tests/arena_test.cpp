@@ -0,0 +1,123 @@
+// ChunkedArena has to keep every object at the address it was added at, and a reserved bulk in one chunk;
+// StringPool has to hand out one view per distinct string that outlives the interned text.
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "arena.h"
+
+#include "test_framework.h"
+
+namespace {
+
+static_assert(!std::is_copy_constructible_v<arena::ChunkedArena<int>>);
+static_assert(std::is_move_constructible_v<arena::ChunkedArena<int>>);
+
+void TestAddressesStayValid() {
+    arena::ChunkedArena<std::string> strings(4);
+    CHECK(strings.empty());
+
+    std::vector<const std::string*> addresses;
+    for (int index = 0; index < 100; ++index) {
+        addresses.push_back(&strings.Emplace(std::to_string(index)));
+    }
+    CHECK_EQUAL(strings.size(), 100u);
+    CHECK(!strings.empty());
+    for (int index = 0; index < 100; ++index) {
+        CHECK_EQUAL(*addresses[index], std::to_string(index));
+    }
+}
+
+void TestObjectsOfChunkAreContiguous() {
+    arena::ChunkedArena<int> numbers(8);
+    std::vector<const int*> addresses;
+    for (int index = 0; index < 8; ++index) {
+        addresses.push_back(&numbers.Emplace(index));
+    }
+    for (size_t index = 0; index < addresses.size(); ++index) {
+        CHECK(addresses[index] == addresses[0] + index);
+    }
+}
+
+void TestReserveTakesOneChunk() {
+    arena::ChunkedArena<int> numbers(4);
+    numbers.Emplace(-1);
+    numbers.Reserve(1000);
+
+    std::vector<const int*> addresses;
+    for (int index = 0; index < 1000; ++index) {
+        addresses.push_back(&numbers.Emplace(index));
+    }
+    for (size_t index = 0; index < addresses.size(); ++index) {
+        CHECK(addresses[index] == addresses[0] + index);
+    }
+    CHECK_EQUAL(numbers.size(), 1001u);
+}
+
+// Room left in the last chunk is used before a new one is taken.
+void TestReserveUsesRoomLeft() {
+    arena::ChunkedArena<int> numbers(16);
+    const int* first = &numbers.Emplace(0);
+    numbers.Reserve(15);
+    for (int index = 1; index < 16; ++index) {
+        CHECK(&numbers.Emplace(index) == first + index);
+    }
+}
+
+void TestMoveKeepsAddresses() {
+    arena::ChunkedArena<std::string> strings(2);
+    std::vector<const std::string*> addresses;
+    for (int index = 0; index < 5; ++index) {
+        addresses.push_back(&strings.Emplace(std::to_string(index)));
+    }
+
+    arena::ChunkedArena<std::string> moved(std::move(strings));
+    CHECK_EQUAL(moved.size(), 5u);
+    for (int index = 0; index < 5; ++index) {
+        CHECK_EQUAL(*addresses[index], std::to_string(index));
+    }
+}
+
+void TestInternKeepsOneCopy() {
+    arena::StringPool pool;
+    std::string text = "Stop 1";
+    const std::string_view first = pool.Intern(text);
+    text = "Something else";
+
+    CHECK_EQUAL(first, "Stop 1");
+    const std::string_view second = pool.Intern(std::string("Stop 1"));
+    CHECK(second.data() == first.data());
+    CHECK(pool.Intern("Stop 2").data() != first.data());
+    CHECK_EQUAL(pool.size(), 2u);
+}
+
+// Views handed out before the pool grew past its reserve still point to their strings.
+void TestInternedViewsStayValid() {
+    arena::StringPool pool;
+    pool.Reserve(10);
+    std::vector<std::string_view> views;
+    for (int index = 0; index < 1000; ++index) {
+        views.push_back(pool.Intern(std::to_string(index)));
+    }
+    for (int index = 0; index < 1000; ++index) {
+        CHECK_EQUAL(views[index], std::to_string(index));
+        CHECK(pool.Intern(std::to_string(index)).data() == views[index].data());
+    }
+    CHECK_EQUAL(pool.size(), 1000u);
+}
+
+}  // namespace
+
+int main() {
+    RUN_TEST(TestAddressesStayValid);
+    RUN_TEST(TestObjectsOfChunkAreContiguous);
+    RUN_TEST(TestReserveTakesOneChunk);
+    RUN_TEST(TestReserveUsesRoomLeft);
+    RUN_TEST(TestMoveKeepsAddresses);
+    RUN_TEST(TestInternKeepsOneCopy);
+    RUN_TEST(TestInternedViewsStayValid);
+    return testing::Finish();
+}
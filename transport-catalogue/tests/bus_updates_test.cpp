@@ -0,0 +1,269 @@
+// Buses added to and removed from a built router through RequestHandler have to give the same routes
+// as a router built from scratch over the resulting buses. The test is built once per routing weight type.
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "geo.h"
+#include "map_renderer.h"
+#include "request_handler.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+#include "test_framework.h"
+#include "test_network.h"
+
+using namespace catalogue_core;
+
+namespace {
+
+constexpr uint32_t SEED = 20240502;
+constexpr size_t STOP_COUNT = 40;
+constexpr size_t BUS_COUNT = 14;
+constexpr size_t INITIAL_BUS_COUNT = 8;
+// Not round, so that no two different routes take exactly as long (see routing_engines_test.cpp).
+constexpr int BUS_WAIT_TIME = 7;
+constexpr double BUS_VELOCITY = 36.123;
+
+constexpr bool FIXED_POINT_WEIGHTS = std::is_integral_v<router::RouteWeight>;
+
+struct Fixture {
+    Fixture(const testing::TestNetwork& network, const std::vector<size_t>& bus_indices, router::RouterSettings settings)
+        : handler(catalogue, map_renderer) {
+        testing::LoadNetwork(handler, network, bus_indices);
+        handler.CreateRouter(settings);
+    }
+
+    transport_catalogue::TransportCatalogue catalogue;
+    renderer::MapRenderer map_renderer;
+    RequestHandler handler;
+};
+
+router::RouterSettings MakeSettings(router::RouterEngine engine, bool fold_wait_edges) {
+    router::RouterSettings settings;
+    settings.bus_wait_time = BUS_WAIT_TIME;
+    settings.bus_velocity = BUS_VELOCITY;
+    settings.engine = engine;
+    settings.fold_wait_edges = fold_wait_edges;
+    settings.landmark_count = 4;
+    return settings;
+}
+
+// Every route of the updated router against a router built over the same buses and against brute force.
+void CheckSameRoutes(const testing::TestNetwork& network, const std::vector<size_t>& bus_indices,
+                     router::RouterSettings settings, RequestHandler& updated) {
+    Fixture rebuilt(network, bus_indices, settings);
+    const auto expected_times = testing::ComputeFastestTimes(network, bus_indices, BUS_WAIT_TIME, BUS_VELOCITY);
+
+    const size_t stop_count = network.stop_names.size();
+    std::vector<router::RoutePart> itinerary;
+    std::vector<router::RoutePart> expected_itinerary;
+    for (size_t from = 0; from < stop_count; ++from) {
+        for (size_t to = 0; to < stop_count; ++to) {
+            // A stop without buses has no vertices in a rebuilt router, so it has no route even to itself.
+            if (from == to) {
+                continue;
+            }
+            const auto total_time = updated.BuildFastestRoute(network.stop_names[from], network.stop_names[to], itinerary);
+            const auto expected_time = rebuilt.handler.BuildFastestRoute(network.stop_names[from], network.stop_names[to], expected_itinerary);
+            CHECK_EQUAL(total_time.has_value(), expected_time.has_value());
+            CHECK_EQUAL(total_time.has_value(), std::isfinite(expected_times[from][to]));
+            if (!total_time.has_value() || !expected_time.has_value()) {
+                continue;
+            }
+
+            // Fixed-point weights round every edge, so the rounded sums of two routes may tie.
+            const double tolerance = FIXED_POINT_WEIGHTS ? stop_count / router::ROUTE_WEIGHT_UNITS_PER_MINUTE : 1e-9 * *expected_time;
+            CHECK_NEAR(*total_time, expected_times[from][to], tolerance);
+            if (FIXED_POINT_WEIGHTS) {
+                continue;
+            }
+            CHECK_NEAR(*total_time, *expected_time, tolerance);
+            CHECK_EQUAL(itinerary.size(), expected_itinerary.size());
+            for (size_t index = 0; index < std::min(itinerary.size(), expected_itinerary.size()); ++index) {
+                CHECK_EQUAL(itinerary[index].wait_or_bus, expected_itinerary[index].wait_or_bus);
+                CHECK_EQUAL(itinerary[index].bus_name, expected_itinerary[index].bus_name);
+                CHECK_EQUAL(itinerary[index].stop_name, expected_itinerary[index].stop_name);
+                CHECK_EQUAL(itinerary[index].span_count, expected_itinerary[index].span_count);
+            }
+        }
+    }
+}
+
+// The last bus rides between the two stops farthest apart on a road much shorter than the straight line,
+// so adding it lowers the bound of A* below the real times.
+testing::TestNetwork GenerateNetworkWithExpressBus() {
+    testing::TestNetwork network = testing::GenerateNetwork(SEED, STOP_COUNT, BUS_COUNT);
+    size_t express_from = 0;
+    size_t express_to = 0;
+    double longest = 0.0;
+    for (size_t from = 0; from < STOP_COUNT; ++from) {
+        for (size_t to = from + 1; to < STOP_COUNT; ++to) {
+            const double distance = geo::ComputeDistance(network.coordinates[from], network.coordinates[to]);
+            if (distance > longest && network.lengths.count({ from, to }) == 0 && network.lengths.count({ to, from }) == 0) {
+                longest = distance;
+                express_from = from;
+                express_to = to;
+            }
+        }
+    }
+    network.lengths[{ express_from, express_to }] = static_cast<int>(longest * 0.3);
+    network.buses.push_back({ "Express", false, { express_from, express_to } });
+    return network;
+}
+
+void TestUpdatesMatchRebuiltRouter() {
+    const testing::TestNetwork network = GenerateNetworkWithExpressBus();
+    std::vector<size_t> initial_buses;
+    for (size_t bus = 0; bus < INITIAL_BUS_COUNT; ++bus) {
+        initial_buses.push_back(bus);
+    }
+
+    // Adds the rest of the buses, removes a few of them and of the initial ones, and brings one back.
+    struct Update {
+        bool add;
+        size_t bus;
+    };
+    std::vector<Update> updates;
+    for (size_t bus = INITIAL_BUS_COUNT; bus < network.buses.size(); ++bus) {
+        updates.push_back({ true, bus });
+    }
+    updates.push_back({ false, 3 });
+    updates.push_back({ false, BUS_COUNT - 2 });
+    updates.push_back({ true, 3 });
+    updates.push_back({ false, 0 });
+
+    const router::RouterEngine engines[] = {
+        router::RouterEngine::PRECOMPUTED,
+        router::RouterEngine::DIJKSTRA,
+        router::RouterEngine::RAPTOR,
+        router::RouterEngine::A_STAR,
+        router::RouterEngine::BIDIRECTIONAL_DIJKSTRA,
+    };
+    for (const bool fold_wait_edges : { false, true }) {
+        for (const router::RouterEngine engine : engines) {
+            const router::RouterSettings settings = MakeSettings(engine, fold_wait_edges);
+            Fixture updated(network, initial_buses, settings);
+            std::vector<size_t> bus_indices = initial_buses;
+
+            for (const Update& update : updates) {
+                const testing::TestBus& bus = network.buses[update.bus];
+                if (update.add) {
+                    updated.handler.AddBusRoute(testing::ToBusRouteRaw(network, bus));
+                    bus_indices.push_back(update.bus);
+                } else {
+                    updated.handler.RemoveBusRoute(bus.name);
+                    bus_indices.erase(std::find(bus_indices.begin(), bus_indices.end(), update.bus));
+                }
+                CHECK_EQUAL(updated.catalogue.FindBusRoute(bus.name) != nullptr, update.add);
+                CheckSameRoutes(network, bus_indices, settings, updated.handler);
+            }
+        }
+    }
+}
+
+// Buses along the same stops ride equally long. Whatever the order of the updates, the ride has to be
+// on the bus a rebuilt router keeps: the first one by name.
+void TestEqualRidesKeepFirstBusByName() {
+    testing::TestNetwork network;
+    for (size_t stop = 0; stop < 3; ++stop) {
+        network.stop_names.push_back("Stop " + std::to_string(stop));
+        network.coordinates.push_back({ 55.60 + 0.01 * static_cast<double>(stop), 37.60 });
+    }
+    network.lengths[{ 0, 1 }] = 1500;
+    network.lengths[{ 1, 2 }] = 1700;
+    network.buses = { { "B", false, { 0, 1, 2 } }, { "A", false, { 0, 1, 2 } }, { "C", false, { 0, 1, 2 } } };
+
+    const router::RouterEngine engines[] = {
+        router::RouterEngine::PRECOMPUTED,
+        router::RouterEngine::DIJKSTRA,
+        router::RouterEngine::A_STAR,
+        router::RouterEngine::BIDIRECTIONAL_DIJKSTRA,
+    };
+    for (const bool fold_wait_edges : { false, true }) {
+        for (const router::RouterEngine engine : engines) {
+            const router::RouterSettings settings = MakeSettings(engine, fold_wait_edges);
+            Fixture updated(network, { 0 }, settings);
+            const auto check_bus = [&](const std::vector<size_t>& bus_indices, const std::string& bus_name) {
+                std::vector<router::RoutePart> itinerary;
+                CHECK(updated.handler.BuildFastestRoute("Stop 0", "Stop 2", itinerary).has_value());
+                CHECK_EQUAL(itinerary.size(), 2u);
+                if (itinerary.size() == 2) {
+                    CHECK_EQUAL(itinerary[1].bus_name, bus_name);
+                }
+                CheckSameRoutes(network, bus_indices, settings, updated.handler);
+            };
+
+            updated.handler.AddBusRoute(testing::ToBusRouteRaw(network, network.buses[1]));
+            check_bus({ 0, 1 }, "A");
+            updated.handler.AddBusRoute(testing::ToBusRouteRaw(network, network.buses[2]));
+            check_bus({ 0, 1, 2 }, "A");
+            updated.handler.RemoveBusRoute("A");
+            check_bus({ 0, 2 }, "B");
+            updated.handler.RemoveBusRoute("B");
+            check_bus({ 2 }, "C");
+        }
+    }
+}
+
+void TestWrongUpdatesAreRejected() {
+    const testing::TestNetwork network = testing::GenerateNetwork(SEED, STOP_COUNT, BUS_COUNT);
+    Fixture fixture(network, { 0, 1, 2 }, MakeSettings(router::RouterEngine::DIJKSTRA, false));
+
+    CHECK_THROWS(fixture.handler.AddBusRoute(testing::ToBusRouteRaw(network, network.buses[1])), std::invalid_argument);
+    CHECK_THROWS(fixture.handler.RemoveBusRoute(network.buses[5].name), std::invalid_argument);
+
+    BusRouteRaw unknown_stop = testing::ToBusRouteRaw(network, network.buses[5]);
+    unknown_stop.stops.push_back("No such stop");
+    CHECK_THROWS(fixture.handler.AddBusRoute(unknown_stop), std::invalid_argument);
+    CHECK(fixture.catalogue.FindBusRoute(unknown_stop.name) == nullptr);
+}
+
+// std::invalid_argument is a std::logic_error too, but it would mean a wrong update rather than a refused one.
+template <typename Update>
+bool IsRefused(Update update) {
+    try {
+        update();
+    } catch (const std::invalid_argument&) {
+        return false;
+    } catch (const std::logic_error&) {
+        return true;
+    }
+    return false;
+}
+
+// Engines with precomputes over the whole graph refuse updates and leave the catalogue as it was.
+void TestUpdatesNeedSupportingEngine() {
+    const testing::TestNetwork network = testing::GenerateNetwork(SEED, STOP_COUNT, BUS_COUNT);
+    const router::RouterEngine engines[] = {
+        router::RouterEngine::CONTRACTION_HIERARCHY,
+        router::RouterEngine::ALT,
+        router::RouterEngine::HUB_LABELS,
+    };
+    for (const router::RouterEngine engine : engines) {
+        Fixture fixture(network, { 0, 1, 2 }, MakeSettings(engine, false));
+
+        CHECK(IsRefused([&] {
+            fixture.handler.AddBusRoute(testing::ToBusRouteRaw(network, network.buses[5]));
+        }));
+        CHECK(fixture.catalogue.FindBusRoute(network.buses[5].name) == nullptr);
+        CHECK(IsRefused([&] {
+            fixture.handler.RemoveBusRoute(network.buses[1].name);
+        }));
+        CHECK(fixture.catalogue.FindBusRoute(network.buses[1].name) != nullptr);
+    }
+}
+
+}  // namespace
+
+int main() {
+    RUN_TEST(TestUpdatesMatchRebuiltRouter);
+    RUN_TEST(TestEqualRidesKeepFirstBusByName);
+    RUN_TEST(TestWrongUpdatesAreRejected);
+    RUN_TEST(TestUpdatesNeedSupportingEngine);
+    return testing::Finish();
+}
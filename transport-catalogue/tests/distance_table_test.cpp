@@ -0,0 +1,136 @@
+// DistanceTable has to answer like a std::map of the lengths set, with the reverse direction
+// falling back to the length set the other way, whether or not room was reserved ahead.
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <random>
+#include <utility>
+
+#include "distance_table.h"
+
+#include "test_framework.h"
+
+using namespace catalogue_core;
+
+namespace {
+
+using Lengths = std::map<std::pair<domain::StopId, domain::StopId>, int>;
+
+std::optional<int> GetExpected(const Lengths& lengths, domain::StopId from, domain::StopId to) {
+    if (const auto it = lengths.find({ from, to }); it != lengths.end()) {
+        return it->second;
+    }
+    if (const auto it = lengths.find({ to, from }); it != lengths.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+void CheckSameLengths(const transport_catalogue::DistanceTable& table, const Lengths& lengths, domain::StopId stop_count) {
+    for (domain::StopId from = 0; from < stop_count; ++from) {
+        for (domain::StopId to = 0; to < stop_count; ++to) {
+            const std::optional<int> length = table.Get(from, to);
+            const std::optional<int> expected = GetExpected(lengths, from, to);
+            CHECK_EQUAL(length.has_value(), expected.has_value());
+            CHECK_EQUAL(length.value_or(-1), expected.value_or(-1));
+        }
+    }
+
+    Lengths listed;
+    table.ForEach([&listed](domain::StopId from, domain::StopId to, int length) {
+        CHECK(listed.emplace(std::make_pair(from, to), length).second);
+    });
+    CHECK(listed == lengths);
+}
+
+void TestEmptyTable() {
+    const transport_catalogue::DistanceTable table;
+    CHECK(!table.Get(0, 0).has_value());
+    CHECK(!table.Get(1, 2).has_value());
+    CheckSameLengths(table, {}, 4);
+}
+
+// The reverse direction takes the length set the other way until it is set itself, in either order.
+void TestReverseFallback() {
+    transport_catalogue::DistanceTable table;
+    table.Set(1, 2, 100);
+    CHECK_EQUAL(table.Get(2, 1).value_or(-1), 100);
+    table.Set(2, 1, 150);
+    CHECK_EQUAL(table.Get(1, 2).value_or(-1), 100);
+    CHECK_EQUAL(table.Get(2, 1).value_or(-1), 150);
+    table.Set(1, 2, 120);
+    CHECK_EQUAL(table.Get(1, 2).value_or(-1), 120);
+    CHECK_EQUAL(table.Get(2, 1).value_or(-1), 150);
+
+    table.Set(4, 3, 70);
+    table.Set(3, 4, 80);
+    table.Set(4, 3, 90);
+    CHECK_EQUAL(table.Get(3, 4).value_or(-1), 80);
+    CHECK_EQUAL(table.Get(4, 3).value_or(-1), 90);
+
+    table.Set(5, 5, 10);
+    CheckSameLengths(table, { { { 1, 2 }, 120 }, { { 2, 1 }, 150 }, { { 3, 4 }, 80 }, { { 4, 3 }, 90 }, { { 5, 5 }, 10 } }, 6);
+}
+
+// Random lengths over few enough stops that keys collide in their groups and the table is rehashed often.
+void TestMatchesMap() {
+    constexpr domain::StopId STOP_COUNT = 60;
+    std::mt19937 rng(5);
+
+    for (const bool reserve : { false, true }) {
+        transport_catalogue::DistanceTable table;
+        Lengths lengths;
+        if (reserve) {
+            table.Reserve(1000);
+        }
+        for (int step = 0; step < 1000; ++step) {
+            const auto from = static_cast<domain::StopId>(rng() % STOP_COUNT);
+            const auto to = static_cast<domain::StopId>(rng() % STOP_COUNT);
+            const int length = static_cast<int>(rng() % 10000);
+            table.Set(from, to, length);
+            lengths[{ from, to }] = length;
+            if (step % 100 == 0) {
+                CheckSameLengths(table, lengths, STOP_COUNT);
+            }
+        }
+        CheckSameLengths(table, lengths, STOP_COUNT);
+    }
+}
+
+// Reserving room after some lengths are set keeps them, as does a Reserve that needs no rehash.
+void TestReserveKeepsLengths() {
+    transport_catalogue::DistanceTable table;
+    Lengths lengths;
+    for (domain::StopId stop = 0; stop < 20; ++stop) {
+        table.Set(stop, stop + 1, static_cast<int>(stop) * 10);
+        lengths[{ stop, stop + 1 }] = static_cast<int>(stop) * 10;
+    }
+    table.Reserve(500);
+    CheckSameLengths(table, lengths, 21);
+    table.Reserve(1);
+    CheckSameLengths(table, lengths, 21);
+}
+
+// Ids far apart, which only differ in their high bits once packed into a key.
+void TestLargeIds() {
+    transport_catalogue::DistanceTable table;
+    constexpr domain::StopId LARGE = 0xFFFF0000u;
+    table.Set(LARGE, 1, 5);
+    table.Set(1, LARGE + 1, 6);
+    CHECK_EQUAL(table.Get(1, LARGE).value_or(-1), 5);
+    CHECK_EQUAL(table.Get(LARGE + 1, 1).value_or(-1), 6);
+    CHECK(!table.Get(LARGE, LARGE + 1).has_value());
+    CHECK(!table.Get(0, 1).has_value());
+}
+
+}  // namespace
+
+int main() {
+    RUN_TEST(TestEmptyTable);
+    RUN_TEST(TestReverseFallback);
+    RUN_TEST(TestMatchesMap);
+    RUN_TEST(TestReserveKeepsLengths);
+    RUN_TEST(TestLargeIds);
+    return testing::Finish();
+}
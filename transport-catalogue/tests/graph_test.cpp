@@ -0,0 +1,148 @@
+// The CSR arrays of a frozen DirectedWeightedGraph have to list the edges of every vertex in the order
+// they were added, without the removed ones, through any number of Thaw and Freeze rounds.
+
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "graph.h"
+
+#include "test_framework.h"
+
+namespace {
+
+using Graph = graph::DirectedWeightedGraph<double>;
+
+// Every edge ever added, with the ones removed since marked.
+struct ReferenceGraph {
+    size_t vertex_count;
+    std::vector<graph::Edge<double>> edges;
+    std::vector<bool> removed;
+};
+
+void CheckSameGraph(const Graph& graph, const ReferenceGraph& reference) {
+    CHECK(graph.IsFrozen());
+    CHECK_EQUAL(graph.GetVertexCount(), reference.vertex_count);
+    CHECK_EQUAL(graph.GetEdgeCount(), reference.edges.size());
+
+    const auto& arc_offsets = graph.GetArcOffsets();
+    CHECK_EQUAL(arc_offsets.size(), reference.vertex_count + 1);
+    if (arc_offsets.size() != reference.vertex_count + 1) {
+        return;
+    }
+    for (graph::VertexId vertex = 0; vertex < reference.vertex_count; ++vertex) {
+        std::vector<graph::EdgeId> expected_outgoing;
+        std::vector<graph::EdgeId> expected_incoming;
+        for (graph::EdgeId edge_id = 0; edge_id < reference.edges.size(); ++edge_id) {
+            if (reference.removed[edge_id]) {
+                continue;
+            }
+            if (reference.edges[edge_id].from == vertex) {
+                expected_outgoing.push_back(edge_id);
+            }
+            if (reference.edges[edge_id].to == vertex) {
+                expected_incoming.push_back(edge_id);
+            }
+        }
+
+        const auto outgoing = graph.GetIncidentEdges(vertex);
+        CHECK(std::vector<graph::EdgeId>(outgoing.begin(), outgoing.end()) == expected_outgoing);
+        const auto incoming = graph.GetIncomingEdges(vertex);
+        CHECK(std::vector<graph::EdgeId>(incoming.begin(), incoming.end()) == expected_incoming);
+
+        CHECK_EQUAL(arc_offsets[vertex + 1] - arc_offsets[vertex], expected_outgoing.size());
+        for (size_t arc = arc_offsets[vertex]; arc < arc_offsets[vertex + 1]; ++arc) {
+            const graph::EdgeId edge_id = graph.GetArcEdges()[arc];
+            CHECK_EQUAL(graph.GetArcTargets()[arc], reference.edges[edge_id].to);
+            CHECK_EQUAL(graph.GetArcWeights()[arc], reference.edges[edge_id].weight);
+        }
+    }
+    for (graph::EdgeId edge_id = 0; edge_id < reference.edges.size(); ++edge_id) {
+        CHECK_EQUAL(graph.IsRemoved(edge_id), reference.removed[edge_id]);
+        if (!reference.removed[edge_id]) {
+            CHECK_EQUAL(graph.GetEdge(edge_id).from, reference.edges[edge_id].from);
+            CHECK_EQUAL(graph.GetEdge(edge_id).to, reference.edges[edge_id].to);
+            CHECK_EQUAL(graph.GetEdge(edge_id).weight, reference.edges[edge_id].weight);
+        }
+    }
+}
+
+void AddRandomEdges(Graph& graph, ReferenceGraph& reference, std::mt19937& rng, size_t count) {
+    for (size_t index = 0; index < count; ++index) {
+        const graph::Edge<double> edge{ rng() % reference.vertex_count, rng() % reference.vertex_count, static_cast<double>(rng() % 100) };
+        CHECK_EQUAL(graph.AddEdge(edge), reference.edges.size());
+        reference.edges.push_back(edge);
+        reference.removed.push_back(false);
+    }
+}
+
+// Several rounds of thawing, removing and adding edges, parallel edges and loops included.
+void TestFreezeAndThaw() {
+    constexpr size_t VERTEX_COUNT = 30;
+    std::mt19937 rng(17);
+    Graph graph(VERTEX_COUNT);
+    ReferenceGraph reference{ VERTEX_COUNT, {}, {} };
+
+    AddRandomEdges(graph, reference, rng, 200);
+    graph.Freeze();
+    CheckSameGraph(graph, reference);
+
+    for (int round = 0; round < 5; ++round) {
+        graph.Thaw();
+        CHECK(!graph.IsFrozen());
+        for (int removal = 0; removal < 30; ++removal) {
+            const graph::EdgeId edge_id = rng() % reference.edges.size();
+            graph.RemoveEdge(edge_id);
+            reference.removed[edge_id] = true;
+        }
+        AddRandomEdges(graph, reference, rng, 20);
+        graph.Freeze();
+        CheckSameGraph(graph, reference);
+    }
+}
+
+// A graph restored from the CSR arrays of another one is the same graph, removed edges included.
+void TestRestoreFromArrays() {
+    constexpr size_t VERTEX_COUNT = 12;
+    std::mt19937 rng(19);
+    Graph graph(VERTEX_COUNT);
+    ReferenceGraph reference{ VERTEX_COUNT, {}, {} };
+    AddRandomEdges(graph, reference, rng, 50);
+    for (const graph::EdgeId edge_id : { 3u, 10u, 49u }) {
+        graph.RemoveEdge(edge_id);
+        reference.removed[edge_id] = true;
+    }
+    graph.Freeze();
+
+    Graph restored(graph.GetEdgeCount(), std::vector<size_t>(graph.GetArcOffsets()), std::vector<graph::EdgeId>(graph.GetArcEdges()),
+                   std::vector<graph::VertexId>(graph.GetArcTargets()), std::vector<double>(graph.GetArcWeights()));
+    CheckSameGraph(restored, reference);
+
+    // A restored graph can be changed like any frozen one.
+    restored.Thaw();
+    AddRandomEdges(restored, reference, rng, 5);
+    restored.Freeze();
+    CheckSameGraph(restored, reference);
+}
+
+void TestMisuseIsRejected() {
+    Graph graph(3);
+    graph.AddEdge({ 0, 1, 1.0 });
+    CHECK_THROWS(graph.GetIncomingEdges(0), std::logic_error);
+    graph.Freeze();
+    CHECK_THROWS(graph.AddEdge({ 1, 2, 1.0 }), std::logic_error);
+    CHECK_THROWS(graph.RemoveEdge(0), std::logic_error);
+
+    CHECK_THROWS(Graph(1, { 0, 1 }, { 0 }, {}, { 1.0 }), std::invalid_argument);
+    CHECK_THROWS(Graph(1, {}, {}, {}, {}), std::invalid_argument);
+}
+
+}  // namespace
+
+int main() {
+    RUN_TEST(TestFreezeAndThaw);
+    RUN_TEST(TestRestoreFromArrays);
+    RUN_TEST(TestMisuseIsRejected);
+    return testing::Finish();
+}
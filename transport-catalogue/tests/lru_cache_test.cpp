@@ -0,0 +1,137 @@
+// LruCache has to evict the least recently used entry, where both Get (Visit) and Put make an entry recent.
+
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lru_cache.h"
+
+#include "test_framework.h"
+
+namespace {
+
+void TestEvictsLeastRecentlyUsed() {
+    cache::LruCache<int, std::string> cache(3);
+    cache.Put(1, "one");
+    cache.Put(2, "two");
+    cache.Put(3, "three");
+    cache.Put(4, "four");
+
+    CHECK(!cache.Get(1).has_value());
+    CHECK_EQUAL(cache.Get(2).value_or(""), "two");
+    CHECK_EQUAL(cache.Get(3).value_or(""), "three");
+    CHECK_EQUAL(cache.Get(4).value_or(""), "four");
+}
+
+void TestGetMakesEntryRecent() {
+    cache::LruCache<int, std::string> cache(3);
+    cache.Put(1, "one");
+    cache.Put(2, "two");
+    cache.Put(3, "three");
+    CHECK(cache.Get(1).has_value());
+    cache.Put(4, "four");
+
+    CHECK_EQUAL(cache.Get(1).value_or(""), "one");
+    CHECK(!cache.Get(2).has_value());
+    CHECK(cache.Get(3).has_value());
+    CHECK(cache.Get(4).has_value());
+}
+
+void TestVisitMakesEntryRecent() {
+    cache::LruCache<int, std::string> cache(2);
+    cache.Put(1, "one");
+    cache.Put(2, "two");
+
+    std::string visited;
+    CHECK(cache.Visit(1, [&visited](const std::string& value) {
+        visited = value;
+    }));
+    CHECK_EQUAL(visited, "one");
+    CHECK(!cache.Visit(3, [](const std::string&) {}));
+    cache.Put(3, "three");
+
+    CHECK(cache.Get(1).has_value());
+    CHECK(!cache.Get(2).has_value());
+}
+
+void TestPutUpdatesExistingEntry() {
+    cache::LruCache<int, std::string> cache(2);
+    cache.Put(1, "one");
+    cache.Put(2, "two");
+    cache.Put(1, "uno");
+    cache.Put(3, "three");
+
+    CHECK_EQUAL(cache.Get(1).value_or(""), "uno");
+    CHECK(!cache.Get(2).has_value());
+    CHECK_EQUAL(cache.Get(3).value_or(""), "three");
+}
+
+void TestZeroCapacityKeepsNothing() {
+    cache::LruCache<int, int> cache(0);
+    cache.Put(1, 1);
+
+    CHECK_EQUAL(cache.GetCapacity(), 0u);
+    CHECK(!cache.Get(1).has_value());
+}
+
+void TestClearAndStatistics() {
+    cache::LruCache<int, int> cache(2);
+    cache.Put(1, 10);
+    CHECK(cache.Get(1).has_value());
+    CHECK(!cache.Get(2).has_value());
+    cache.Clear();
+    CHECK(!cache.Get(1).has_value());
+
+    const cache::CacheStatistics statistics = cache.GetStatistics();
+    CHECK_EQUAL(statistics.hits, 1u);
+    CHECK_EQUAL(statistics.misses, 2u);
+}
+
+// Random Get and Put calls against a list ordered from the most to the least recently used entry.
+void TestMatchesReferenceModel() {
+    constexpr size_t CAPACITY = 5;
+    cache::LruCache<int, int> cache(CAPACITY);
+    std::vector<std::pair<int, int>> model;
+    std::mt19937 rng(3);
+
+    for (int step = 0; step < 10000; ++step) {
+        const int key = static_cast<int>(rng() % 12);
+        const auto it = std::find_if(model.begin(), model.end(), [key](const auto& entry) {
+            return entry.first == key;
+        });
+        if (rng() % 2 == 0) {
+            const std::optional<int> value = cache.Get(key);
+            CHECK_EQUAL(value.has_value(), it != model.end());
+            if (it != model.end()) {
+                CHECK_EQUAL(value.value_or(-1), it->second);
+                std::rotate(model.begin(), it, it + 1);
+            }
+        } else {
+            const int value = static_cast<int>(rng() % 1000);
+            cache.Put(key, value);
+            if (it != model.end()) {
+                model.erase(it);
+            }
+            model.insert(model.begin(), { key, value });
+            if (model.size() > CAPACITY) {
+                model.pop_back();
+            }
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    RUN_TEST(TestEvictsLeastRecentlyUsed);
+    RUN_TEST(TestGetMakesEntryRecent);
+    RUN_TEST(TestVisitMakesEntryRecent);
+    RUN_TEST(TestPutUpdatesExistingEntry);
+    RUN_TEST(TestZeroCapacityKeepsNothing);
+    RUN_TEST(TestClearAndStatistics);
+    RUN_TEST(TestMatchesReferenceModel);
+    return testing::Finish();
+}
@@ -0,0 +1,172 @@
+// The SIMD min-plus kernels of floyd_warshall.cpp have to match the scalar one bit for bit, on every
+// tail length, with infinite cells and with sums that overflow (saturate for uint32 weights).
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "floyd_warshall.h"
+#include "weight_traits.h"
+
+#include "test_framework.h"
+
+namespace {
+
+const graph::MinPlusKernel SIMD_KERNELS[] = { graph::MinPlusKernel::SSE2, graph::MinPlusKernel::AVX2 };
+
+// Long enough for every tail after full 4- and 8-lane blocks.
+constexpr size_t MAX_COUNT = 3 * 8 + 8;
+
+template <typename Weight>
+std::vector<Weight> GetSpecialWeights();
+
+template <>
+std::vector<float> GetSpecialWeights<float>() {
+    return { 0.0f, 1.0f, std::numeric_limits<float>::infinity(), std::numeric_limits<float>::max(), 3e38f, 1e38f };
+}
+
+// Around 2^31 the SSE2 and AVX2 kernels flip the sign bit to compare unsigned values.
+template <>
+std::vector<uint32_t> GetSpecialWeights<uint32_t>() {
+    constexpr uint32_t INFINITE_WEIGHT = graph::WeightTraits<uint32_t>::INFINITE_WEIGHT;
+    return { 0u, 1u, INFINITE_WEIGHT, INFINITE_WEIGHT - 1u, INFINITE_WEIGHT - 1000u, 0x7fffffffu, 0x80000000u, 0x80000001u };
+}
+
+template <typename Weight>
+Weight GenerateWeight(std::mt19937& rng) {
+    const std::vector<Weight> special = GetSpecialWeights<Weight>();
+    if (rng() % 3 == 0) {
+        return special[rng() % special.size()];
+    }
+    return static_cast<Weight>(rng() % 1000);
+}
+
+template <typename Weight>
+bool IsSameBits(const std::vector<Weight>& lhs, const std::vector<Weight>& rhs) {
+    return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(Weight)) == 0;
+}
+
+template <typename Weight>
+void CheckKernelsMatchScalar() {
+    std::mt19937 rng(7);
+    std::vector<Weight> weights_from = GetSpecialWeights<Weight>();
+    weights_from.push_back(static_cast<Weight>(123));
+
+    for (const graph::MinPlusKernel kernel : SIMD_KERNELS) {
+        if (!graph::IsMinPlusKernelSupported(kernel)) {
+            continue;
+        }
+        for (size_t count = 0; count <= MAX_COUNT; ++count) {
+            for (const Weight weight_from : weights_from) {
+                for (int repeat = 0; repeat < 8; ++repeat) {
+                    // One cell more than count, which no kernel may touch, and an unaligned start.
+                    std::vector<Weight> weights_through(count + 2);
+                    std::vector<Weight> weights_relaxing(count + 2);
+                    std::vector<uint32_t> prev_edges_through(count + 2);
+                    std::vector<uint32_t> prev_edges_relaxing(count + 2);
+                    for (size_t j = 0; j < count + 2; ++j) {
+                        weights_through[j] = GenerateWeight<Weight>(rng);
+                        weights_relaxing[j] = GenerateWeight<Weight>(rng);
+                        prev_edges_through[j] = static_cast<uint32_t>(rng());
+                        prev_edges_relaxing[j] = static_cast<uint32_t>(rng());
+                    }
+
+                    std::vector<Weight> expected_weights = weights_relaxing;
+                    std::vector<uint32_t> expected_prev_edges = prev_edges_relaxing;
+                    graph::RelaxRow(graph::MinPlusKernel::SCALAR, weight_from, weights_through.data() + 1, prev_edges_through.data() + 1,
+                                    expected_weights.data() + 1, expected_prev_edges.data() + 1, count);
+                    graph::RelaxRow(kernel, weight_from, weights_through.data() + 1, prev_edges_through.data() + 1,
+                                    weights_relaxing.data() + 1, prev_edges_relaxing.data() + 1, count);
+
+                    CHECK(IsSameBits(weights_relaxing, expected_weights));
+                    CHECK(prev_edges_relaxing == expected_prev_edges);
+                }
+            }
+        }
+    }
+}
+
+void TestKernelsMatchScalarOnFloat() {
+    CheckKernelsMatchScalar<float>();
+}
+
+void TestKernelsMatchScalarOnUint32() {
+    CheckKernelsMatchScalar<uint32_t>();
+}
+
+void TestScalarKernel() {
+    constexpr uint32_t INFINITE_WEIGHT = graph::WeightTraits<uint32_t>::INFINITE_WEIGHT;
+    const std::vector<uint32_t> weights_through = { 1u, INFINITE_WEIGHT, 5u, INFINITE_WEIGHT - 5u };
+    const std::vector<uint32_t> prev_edges_through = { 10u, 11u, 12u, 13u };
+    std::vector<uint32_t> weights_relaxing = { 20u, INFINITE_WEIGHT, 10u, INFINITE_WEIGHT };
+    std::vector<uint32_t> prev_edges_relaxing = { 0u, 1u, 2u, 3u };
+
+    graph::RelaxRow(graph::MinPlusKernel::SCALAR, 5u, weights_through.data(), prev_edges_through.data(),
+                    weights_relaxing.data(), prev_edges_relaxing.data(), weights_through.size());
+
+    // A tie keeps the current cell, a saturated sum never relaxes anything.
+    CHECK(weights_relaxing == std::vector<uint32_t>({ 6u, INFINITE_WEIGHT, 10u, INFINITE_WEIGHT }));
+    CHECK(prev_edges_relaxing == std::vector<uint32_t>({ 10u, 1u, 2u, 3u }));
+}
+
+// A table over several tiles, with unreachable cells, against plain Floyd-Warshall.
+void TestFloydWarshallMatchesPlain() {
+    constexpr size_t VERTEX_COUNT = 150;
+    constexpr uint32_t INFINITE_WEIGHT = graph::WeightTraits<uint32_t>::INFINITE_WEIGHT;
+    std::mt19937 rng(11);
+
+    std::vector<uint32_t> weights(VERTEX_COUNT * VERTEX_COUNT, INFINITE_WEIGHT);
+    std::vector<uint32_t> prev_edges(VERTEX_COUNT * VERTEX_COUNT, 0);
+    for (size_t from = 0; from < VERTEX_COUNT; ++from) {
+        for (size_t to = 0; to < VERTEX_COUNT; ++to) {
+            if (from == to) {
+                weights[from * VERTEX_COUNT + to] = 0;
+            } else if (rng() % 20 == 0) {
+                weights[from * VERTEX_COUNT + to] = 1 + rng() % 100000;
+                prev_edges[from * VERTEX_COUNT + to] = static_cast<uint32_t>(from * VERTEX_COUNT + to);
+            }
+        }
+    }
+
+    const std::vector<uint32_t> edge_weights = weights;
+    std::vector<uint32_t> expected_weights = weights;
+    for (size_t through = 0; through < VERTEX_COUNT; ++through) {
+        for (size_t from = 0; from < VERTEX_COUNT; ++from) {
+            for (size_t to = 0; to < VERTEX_COUNT; ++to) {
+                const uint32_t candidate = graph::WeightTraits<uint32_t>::Add(expected_weights[from * VERTEX_COUNT + through],
+                                                                              expected_weights[through * VERTEX_COUNT + to]);
+                expected_weights[from * VERTEX_COUNT + to] = std::min(expected_weights[from * VERTEX_COUNT + to], candidate);
+            }
+        }
+    }
+
+    graph::FloydWarshall(VERTEX_COUNT, weights.data(), prev_edges.data());
+    CHECK(weights == expected_weights);
+
+    // The prev edge of a cell ends the route: it comes into the cell's vertex and the rest of the route weighs what is left.
+    for (size_t from = 0; from < VERTEX_COUNT; ++from) {
+        for (size_t to = 0; to < VERTEX_COUNT; ++to) {
+            const uint32_t weight = weights[from * VERTEX_COUNT + to];
+            if (from == to || weight == INFINITE_WEIGHT) {
+                continue;
+            }
+            const uint32_t prev_edge = prev_edges[from * VERTEX_COUNT + to];
+            const size_t edge_from = prev_edge / VERTEX_COUNT;
+            CHECK_EQUAL(prev_edge % VERTEX_COUNT, to);
+            CHECK_EQUAL(weights[from * VERTEX_COUNT + edge_from] + edge_weights[prev_edge], weight);
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    RUN_TEST(TestKernelsMatchScalarOnFloat);
+    RUN_TEST(TestKernelsMatchScalarOnUint32);
+    RUN_TEST(TestScalarKernel);
+    RUN_TEST(TestFloydWarshallMatchesPlain);
+    return testing::Finish();
+}
@@ -0,0 +1,242 @@
+// Routers built on precomputes over the whole graph have to find routes as light as the plain Dijkstra
+// router does, on random graphs with parallel edges, zero weights and unreachable vertices, both
+// for double and for uint32 weights and when restored from the arrays a base stores.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "a_star_router.h"
+#include "contraction_hierarchy.h"
+#include "dijkstra_router.h"
+#include "graph.h"
+#include "hub_labels.h"
+#include "landmarks.h"
+#include "route_builder.h"
+
+#include "test_framework.h"
+
+namespace {
+
+constexpr size_t VERTEX_COUNT = 60;
+constexpr size_t EDGE_COUNT = 180;
+constexpr uint32_t SEEDS[] = { 1, 2, 3 };
+
+// The last few vertices get no incoming edges, so some routes don't exist.
+template <typename Weight>
+graph::DirectedWeightedGraph<Weight> GenerateGraph(uint32_t seed) {
+    std::mt19937 rng(seed);
+    graph::DirectedWeightedGraph<Weight> graph(VERTEX_COUNT);
+    for (size_t index = 0; index < EDGE_COUNT; ++index) {
+        const graph::VertexId from = rng() % VERTEX_COUNT;
+        const graph::VertexId to = rng() % (VERTEX_COUNT - 5);
+        Weight weight = static_cast<Weight>(rng() % 1000);
+        if constexpr (std::is_floating_point_v<Weight>) {
+            weight /= 7;
+        }
+        graph.AddEdge({ from, to, rng() % 10 == 0 ? Weight{} : weight });
+    }
+    graph.Freeze();
+    return graph;
+}
+
+// Sums of the same edges in another order may differ in the last bits of a double.
+template <typename Weight>
+bool IsSameWeight(Weight weight, Weight expected) {
+    if constexpr (std::is_floating_point_v<Weight>) {
+        return std::abs(weight - expected) <= 1e-9 * std::max<Weight>(1, expected);
+    } else {
+        return weight == expected;
+    }
+}
+
+// Every route of the router is as light as the one of Dijkstra, and its edges lead from "from" to "to"
+// and weigh what the router says.
+template <typename Weight>
+void CheckMatchesDijkstra(const graph::DirectedWeightedGraph<Weight>& graph, const graph::RouteBuilder<Weight>& router) {
+    const graph::DijkstraRouter<Weight> dijkstra(graph);
+    std::vector<graph::EdgeId> edges;
+    std::vector<graph::EdgeId> expected_edges;
+    for (graph::VertexId from = 0; from < graph.GetVertexCount(); ++from) {
+        for (graph::VertexId to = 0; to < graph.GetVertexCount(); ++to) {
+            const std::optional<Weight> weight = router.BuildRoute(from, to, edges);
+            const std::optional<Weight> expected = dijkstra.BuildRoute(from, to, expected_edges);
+            CHECK_EQUAL(weight.has_value(), expected.has_value());
+            if (!weight.has_value() || !expected.has_value()) {
+                CHECK(edges.empty());
+                continue;
+            }
+            CHECK(IsSameWeight(*weight, *expected));
+
+            graph::VertexId vertex = from;
+            Weight total{};
+            for (const graph::EdgeId edge_id : edges) {
+                CHECK(edge_id < graph.GetEdgeCount());
+                if (edge_id >= graph.GetEdgeCount()) {
+                    break;
+                }
+                CHECK_EQUAL(graph.GetEdge(edge_id).from, vertex);
+                vertex = graph.GetEdge(edge_id).to;
+                total += graph.GetEdge(edge_id).weight;
+            }
+            CHECK_EQUAL(vertex, to);
+            CHECK(IsSameWeight(total, *weight));
+        }
+    }
+}
+
+template <typename Weight>
+void CheckContractionHierarchy() {
+    for (const uint32_t seed : SEEDS) {
+        const auto graph = GenerateGraph<Weight>(seed);
+        const graph::ContractionHierarchy<Weight> hierarchy(graph);
+        CheckMatchesDijkstra(graph, hierarchy);
+
+        // Every shortcut stands for two consecutive edges or shortcuts whose weights add up to its own.
+        const auto& shortcuts = hierarchy.GetShortcuts();
+        const auto get_edge = [&](graph::EdgeId edge_id) {
+            if (edge_id < graph.GetEdgeCount()) {
+                return graph.GetEdge(edge_id);
+            }
+            const auto& shortcut = shortcuts.at(edge_id - graph.GetEdgeCount());
+            return graph::Edge<Weight>{ shortcut.from, shortcut.to, shortcut.weight };
+        };
+        for (size_t index = 0; index < shortcuts.size(); ++index) {
+            const auto& shortcut = shortcuts[index];
+            CHECK(shortcut.first_edge < graph.GetEdgeCount() + index);
+            CHECK(shortcut.second_edge < graph.GetEdgeCount() + index);
+            const graph::Edge<Weight> first = get_edge(shortcut.first_edge);
+            const graph::Edge<Weight> second = get_edge(shortcut.second_edge);
+            CHECK_EQUAL(first.from, shortcut.from);
+            CHECK_EQUAL(first.to, second.from);
+            CHECK_EQUAL(second.to, shortcut.to);
+            CHECK(IsSameWeight<Weight>(first.weight + second.weight, shortcut.weight));
+        }
+
+        graph::ContractionHierarchy<Weight> restored(graph, std::vector<uint32_t>(hierarchy.GetRanks()),
+                                                     std::vector<typename graph::ContractionHierarchy<Weight>::Shortcut>(hierarchy.GetShortcuts()));
+        CheckMatchesDijkstra(graph, restored);
+    }
+}
+
+void TestContractionHierarchyOnDouble() {
+    CheckContractionHierarchy<double>();
+}
+
+void TestContractionHierarchyOnUint32() {
+    CheckContractionHierarchy<uint32_t>();
+}
+
+// The bounds never exceed the weights of the lightest routes, so A* with them finds those routes.
+template <typename Weight>
+void CheckLandmarks() {
+    for (const uint32_t seed : SEEDS) {
+        const auto graph = GenerateGraph<Weight>(seed);
+        const auto landmarks = std::make_shared<graph::Landmarks<Weight>>(graph, 4, 1);
+        CHECK_EQUAL(landmarks->GetVertices().size(), 4u);
+
+        const graph::DijkstraRouter<Weight> dijkstra(graph);
+        std::vector<graph::EdgeId> edges;
+        for (graph::VertexId from = 0; from < graph.GetVertexCount(); ++from) {
+            CHECK_EQUAL(landmarks->GetLowerBound(from, from), Weight{});
+            for (graph::VertexId to = 0; to < graph.GetVertexCount(); ++to) {
+                // A bound that is exact in reals may come out a little heavier in doubles.
+                if (const std::optional<Weight> weight = dijkstra.BuildRoute(from, to, edges); weight.has_value()) {
+                    const Weight bound = landmarks->GetLowerBound(from, to);
+                    CHECK(!(*weight < bound) || IsSameWeight(bound, *weight));
+                }
+            }
+        }
+
+        const graph::AStarRouter<Weight> alt(graph, [landmarks](graph::VertexId from, graph::VertexId to) {
+            return landmarks->GetLowerBound(from, to);
+        });
+        CheckMatchesDijkstra(graph, alt);
+
+        // The tables don't depend on the number of threads that fill them, and restore as they are.
+        const graph::Landmarks<Weight> parallel(graph, 4, 4);
+        CHECK(parallel.GetVertices() == landmarks->GetVertices());
+        CHECK(parallel.GetDistancesFrom() == landmarks->GetDistancesFrom());
+        CHECK(parallel.GetDistancesTo() == landmarks->GetDistancesTo());
+
+        const graph::Landmarks<Weight> restored(graph.GetVertexCount(), std::vector<graph::VertexId>(landmarks->GetVertices()),
+                                                std::vector<Weight>(landmarks->GetDistancesFrom()),
+                                                std::vector<Weight>(landmarks->GetDistancesTo()));
+        for (graph::VertexId from = 0; from < graph.GetVertexCount(); ++from) {
+            for (graph::VertexId to = 0; to < graph.GetVertexCount(); ++to) {
+                CHECK_EQUAL(restored.GetLowerBound(from, to), landmarks->GetLowerBound(from, to));
+            }
+        }
+    }
+}
+
+void TestLandmarksOnDouble() {
+    CheckLandmarks<double>();
+}
+
+void TestLandmarksOnUint32() {
+    CheckLandmarks<uint32_t>();
+}
+
+// Every label run is sorted by hub rank, which the merge of a query relies on.
+template <typename Weight>
+void CheckLabelSetSorted(const typename graph::HubLabels<Weight>::LabelSet& labels, size_t vertex_count) {
+    CHECK_EQUAL(labels.offsets.size(), vertex_count + 1);
+    for (size_t vertex = 0; vertex + 1 < labels.offsets.size(); ++vertex) {
+        for (uint32_t entry = labels.offsets[vertex] + 1; entry < labels.offsets[vertex + 1]; ++entry) {
+            CHECK(labels.hubs[entry - 1] < labels.hubs[entry]);
+        }
+    }
+}
+
+template <typename Weight>
+void CheckHubLabels() {
+    for (const uint32_t seed : SEEDS) {
+        const auto graph = GenerateGraph<Weight>(seed);
+        const graph::HubLabels<Weight> hub_labels(graph);
+        CheckMatchesDijkstra(graph, hub_labels);
+
+        std::vector<graph::VertexId> hub_vertices = hub_labels.GetHubVertices();
+        std::sort(hub_vertices.begin(), hub_vertices.end());
+        for (graph::VertexId vertex = 0; vertex < hub_vertices.size(); ++vertex) {
+            CHECK_EQUAL(hub_vertices[vertex], vertex);
+        }
+        CheckLabelSetSorted<Weight>(hub_labels.GetOutLabels(), graph.GetVertexCount());
+        CheckLabelSetSorted<Weight>(hub_labels.GetInLabels(), graph.GetVertexCount());
+
+        using LabelSet = typename graph::HubLabels<Weight>::LabelSet;
+        const graph::HubLabels<Weight> restored(graph, std::vector<graph::VertexId>(hub_labels.GetHubVertices()),
+                                                LabelSet(hub_labels.GetOutLabels()), LabelSet(hub_labels.GetInLabels()));
+        CheckMatchesDijkstra(graph, restored);
+
+        CHECK_THROWS(graph::HubLabels<Weight>(graph, std::vector<graph::VertexId>(3), LabelSet(hub_labels.GetOutLabels()),
+                                              LabelSet(hub_labels.GetInLabels())), std::invalid_argument);
+    }
+}
+
+void TestHubLabelsOnDouble() {
+    CheckHubLabels<double>();
+}
+
+void TestHubLabelsOnUint32() {
+    CheckHubLabels<uint32_t>();
+}
+
+}  // namespace
+
+int main() {
+    RUN_TEST(TestContractionHierarchyOnDouble);
+    RUN_TEST(TestContractionHierarchyOnUint32);
+    RUN_TEST(TestLandmarksOnDouble);
+    RUN_TEST(TestLandmarksOnUint32);
+    RUN_TEST(TestHubLabelsOnDouble);
+    RUN_TEST(TestHubLabelsOnUint32);
+    return testing::Finish();
+}
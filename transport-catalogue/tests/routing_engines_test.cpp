@@ -0,0 +1,272 @@
+// Every routing engine, with and without folded wait edges, has to agree with the brute-force
+// Floyd-Warshall times of test_network.h. The test is built once per routing weight type.
+
+#include <cmath>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "map_renderer.h"
+#include "request_handler.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+#include "test_framework.h"
+#include "test_network.h"
+
+using namespace catalogue_core;
+
+namespace {
+
+constexpr uint32_t SEED = 20240501;
+constexpr size_t STOP_COUNT = 40;
+constexpr size_t BUS_COUNT = 14;
+// Road lengths are whole metres, so with a round velocity a few more rides and one wait less often take
+// exactly as long, and engines may break such a tie differently.
+constexpr int BUS_WAIT_TIME = 7;
+constexpr double BUS_VELOCITY = 36.123;
+
+const router::RouterEngine ENGINES[] = {
+    router::RouterEngine::PRECOMPUTED,
+    router::RouterEngine::DIJKSTRA,
+    router::RouterEngine::CONTRACTION_HIERARCHY,
+    router::RouterEngine::RAPTOR,
+    router::RouterEngine::A_STAR,
+    router::RouterEngine::BIDIRECTIONAL_DIJKSTRA,
+    router::RouterEngine::ALT,
+    router::RouterEngine::HUB_LABELS,
+};
+
+constexpr bool FIXED_POINT_WEIGHTS = std::is_integral_v<router::RouteWeight>;
+
+// Fixed-point weights round every edge by up to half a unit, so the route they choose may be slower
+// than the fastest one by that much per edge; double weights only differ in the order of additions.
+double GetTolerance(double time, size_t edge_count) {
+    const double rounding = FIXED_POINT_WEIGHTS ? static_cast<double>(edge_count) / router::ROUTE_WEIGHT_UNITS_PER_MINUTE : 0.0;
+    return rounding + 1e-9 * std::max(1.0, time);
+}
+
+struct Fixture {
+    Fixture(const testing::TestNetwork& network, router::RouterSettings settings)
+        : handler(catalogue, map_renderer) {
+        testing::LoadNetwork(handler, network);
+        handler.CreateRouter(settings);
+    }
+
+    transport_catalogue::TransportCatalogue catalogue;
+    renderer::MapRenderer map_renderer;
+    RequestHandler handler;
+};
+
+router::RouterSettings MakeSettings(router::RouterEngine engine, bool fold_wait_edges) {
+    router::RouterSettings settings;
+    settings.bus_wait_time = BUS_WAIT_TIME;
+    settings.bus_velocity = BUS_VELOCITY;
+    settings.engine = engine;
+    settings.fold_wait_edges = fold_wait_edges;
+    settings.landmark_count = 4;
+    return settings;
+}
+
+std::vector<bool> GetServedStops(const testing::TestNetwork& network) {
+    std::vector<bool> served(network.stop_names.size(), false);
+    for (const testing::TestBus& bus : network.buses) {
+        for (const size_t stop : bus.stops) {
+            served[stop] = true;
+        }
+    }
+    return served;
+}
+
+// Walks the itinerary from the start: every Wait is at the current stop, every Bus ride goes from there along
+// a real bus, and the times add up to the total.
+void CheckItinerary(const testing::TestNetwork& network, const std::vector<router::RoutePart>& itinerary,
+                    size_t from, size_t to, double total_time) {
+    std::map<std::string, const testing::TestBus*, std::less<>> buses;
+    for (const testing::TestBus& bus : network.buses) {
+        buses[bus.name] = &bus;
+    }
+
+    size_t current = from;
+    double time = 0.0;
+    for (size_t index = 0; index < itinerary.size(); ++index) {
+        const router::RoutePart& wait = itinerary[index];
+        CHECK_EQUAL(wait.wait_or_bus, router::WaitOrBus::WAIT);
+        CHECK_EQUAL(wait.stop_name, network.stop_names[current]);
+        CHECK_EQUAL(wait.wait_time, BUS_WAIT_TIME);
+        time += wait.wait_time;
+
+        CHECK(++index < itinerary.size());
+        if (index == itinerary.size()) {
+            return;
+        }
+        const router::RoutePart& ride = itinerary[index];
+        CHECK_EQUAL(ride.wait_or_bus, router::WaitOrBus::BUS);
+        const auto bus_it = buses.find(ride.bus_name);
+        CHECK(bus_it != buses.end());
+        if (bus_it == buses.end()) {
+            return;
+        }
+        const testing::TestBus& bus = *bus_it->second;
+
+        bool found = false;
+        for (size_t board = 0; board < bus.stops.size() && !found; ++board) {
+            for (size_t alight = 0; alight < bus.stops.size() && !found; ++alight) {
+                const size_t span_count = board < alight ? alight - board : board - alight;
+                if (bus.stops[board] != current || span_count != static_cast<size_t>(ride.span_count)
+                    || (bus.circular && alight < board) || board == alight) {
+                    continue;
+                }
+                const double ride_time = testing::GetRideTime(network, bus, board, alight, BUS_VELOCITY);
+                if (std::abs(ride_time - ride.bus_time) <= 1e-9 * ride_time) {
+                    found = true;
+                    current = bus.stops[alight];
+                }
+            }
+        }
+        CHECK(found);
+        if (!found) {
+            return;
+        }
+        time += ride.bus_time;
+    }
+    CHECK_EQUAL(current, to);
+    CHECK_NEAR(time, total_time, 1e-9 * std::max(1.0, total_time));
+}
+
+void CheckSameItinerary(const std::vector<router::RoutePart>& itinerary, const std::vector<router::RoutePart>& expected) {
+    CHECK_EQUAL(itinerary.size(), expected.size());
+    for (size_t index = 0; index < std::min(itinerary.size(), expected.size()); ++index) {
+        CHECK_EQUAL(itinerary[index].wait_or_bus, expected[index].wait_or_bus);
+        CHECK_EQUAL(itinerary[index].bus_name, expected[index].bus_name);
+        // Only a folded graph knows where a Bus item boards, the Wait before it tells that anyway.
+        if (expected[index].wait_or_bus == router::WaitOrBus::WAIT) {
+            CHECK_EQUAL(itinerary[index].stop_name, expected[index].stop_name);
+        }
+        CHECK_EQUAL(itinerary[index].span_count, expected[index].span_count);
+        CHECK_NEAR(itinerary[index].bus_time, expected[index].bus_time, 1e-9 * std::max(1.0, expected[index].bus_time));
+    }
+}
+
+void TestFastestRoutes() {
+    const testing::TestNetwork network = testing::GenerateNetwork(SEED, STOP_COUNT, BUS_COUNT);
+    std::vector<size_t> all_buses(network.buses.size());
+    for (size_t bus = 0; bus < all_buses.size(); ++bus) {
+        all_buses[bus] = bus;
+    }
+    const auto expected_times = testing::ComputeFastestTimes(network, all_buses, BUS_WAIT_TIME, BUS_VELOCITY);
+    const std::vector<bool> served = GetServedStops(network);
+
+    // The itineraries of the precomputed engine are the reference for the others.
+    Fixture reference(network, MakeSettings(router::RouterEngine::PRECOMPUTED, false));
+    for (const bool fold_wait_edges : { false, true }) {
+        for (const router::RouterEngine engine : ENGINES) {
+            Fixture fixture(network, MakeSettings(engine, fold_wait_edges));
+
+            std::vector<router::RoutePart> itinerary;
+            std::vector<router::RoutePart> expected_itinerary;
+            for (size_t from = 0; from < STOP_COUNT; ++from) {
+                for (size_t to = 0; to < STOP_COUNT; ++to) {
+                    if (!served[from] || !served[to]) {
+                        continue;
+                    }
+                    const auto total_time = fixture.handler.BuildFastestRoute(network.stop_names[from], network.stop_names[to], itinerary);
+                    const double expected_time = expected_times[from][to];
+                    CHECK_EQUAL(total_time.has_value(), std::isfinite(expected_time));
+                    if (!total_time.has_value() || !std::isfinite(expected_time)) {
+                        continue;
+                    }
+                    CHECK_NEAR(*total_time, expected_time, GetTolerance(expected_time, STOP_COUNT));
+                    CheckItinerary(network, itinerary, from, to, *total_time);
+
+                    // Fixed-point weights may choose another route within the tolerance.
+                    if constexpr (!FIXED_POINT_WEIGHTS) {
+                        reference.handler.BuildFastestRoute(network.stop_names[from], network.stop_names[to], expected_itinerary);
+                        CheckSameItinerary(itinerary, expected_itinerary);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void TestRouteCache() {
+    const testing::TestNetwork network = testing::GenerateNetwork(SEED, STOP_COUNT, BUS_COUNT);
+    router::RouterSettings settings = MakeSettings(router::RouterEngine::DIJKSTRA, false);
+    Fixture uncached(network, settings);
+    settings.route_cache_size = 16;
+    Fixture cached(network, settings);
+
+    std::vector<router::RoutePart> itinerary;
+    std::vector<router::RoutePart> expected_itinerary;
+    for (int repeat = 0; repeat < 2; ++repeat) {
+        for (size_t from = 0; from < STOP_COUNT; from += 3) {
+            for (size_t to = 0; to < STOP_COUNT; to += 5) {
+                const auto total_time = cached.handler.BuildFastestRoute(network.stop_names[from], network.stop_names[to], itinerary);
+                const auto expected_time = uncached.handler.BuildFastestRoute(network.stop_names[from], network.stop_names[to], expected_itinerary);
+                CHECK_EQUAL(total_time.has_value(), expected_time.has_value());
+                if (total_time.has_value() && expected_time.has_value()) {
+                    CHECK_EQUAL(*total_time, *expected_time);
+                    CheckSameItinerary(itinerary, expected_itinerary);
+                }
+            }
+        }
+    }
+}
+
+void TestReachableStops() {
+    const testing::TestNetwork network = testing::GenerateNetwork(SEED, STOP_COUNT, BUS_COUNT);
+    std::vector<size_t> all_buses(network.buses.size());
+    for (size_t bus = 0; bus < all_buses.size(); ++bus) {
+        all_buses[bus] = bus;
+    }
+    const auto expected_times = testing::ComputeFastestTimes(network, all_buses, BUS_WAIT_TIME, BUS_VELOCITY);
+    const std::vector<bool> served = GetServedStops(network);
+
+    std::map<std::string, size_t, std::less<>> stop_indices;
+    for (size_t stop = 0; stop < STOP_COUNT; ++stop) {
+        stop_indices[network.stop_names[stop]] = stop;
+    }
+
+    for (const bool fold_wait_edges : { false, true }) {
+        for (const router::RouterEngine engine : ENGINES) {
+            Fixture fixture(network, MakeSettings(engine, fold_wait_edges));
+            for (const double max_time : { -1.0, 10.0, 25.0, 60.0 }) {
+                for (size_t from = 0; from < STOP_COUNT; ++from) {
+                    if (!served[from]) {
+                        continue;
+                    }
+                    const auto reachable = fixture.handler.FindReachableStops(network.stop_names[from], max_time);
+                    CHECK(reachable.has_value());
+                    if (!reachable.has_value()) {
+                        continue;
+                    }
+
+                    std::vector<bool> found(STOP_COUNT, false);
+                    for (const auto& [stop, time] : *reachable) {
+                        const size_t to = stop_indices.find(stop->name)->second;
+                        CHECK(!found[to]);
+                        found[to] = true;
+                        CHECK(time <= max_time);
+                        CHECK_NEAR(time, expected_times[from][to], GetTolerance(expected_times[from][to], STOP_COUNT));
+                    }
+                    for (size_t to = 0; to < STOP_COUNT; ++to) {
+                        if (std::abs(expected_times[from][to] - max_time) > GetTolerance(max_time, STOP_COUNT)) {
+                            CHECK_EQUAL(found[to], expected_times[from][to] <= max_time);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    RUN_TEST(TestFastestRoutes);
+    RUN_TEST(TestRouteCache);
+    RUN_TEST(TestReachableStops);
+    return testing::Finish();
+}
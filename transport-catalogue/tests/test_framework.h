@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Checks for the test executables: a failed check is reported and counted, the test goes on,
+// and Finish turns the count into the exit code that ctest looks at.
+namespace testing {
+
+inline size_t& GetFailureCount() {
+    static size_t failure_count = 0;
+    return failure_count;
+}
+
+inline void ReportFailure(const char* file, int line, const std::string& message) {
+    std::cerr << file << ":" << line << ": " << message << std::endl;
+    ++GetFailureCount();
+}
+
+template <typename Test>
+void RunTest(Test test, const char* name) {
+    const size_t failures_before = GetFailureCount();
+    test();
+    std::cerr << name << (GetFailureCount() == failures_before ? " OK" : " FAILED") << std::endl;
+}
+
+inline int Finish() {
+    return GetFailureCount() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace testing
+
+#define CHECK(condition)                                                                           \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            ::testing::ReportFailure(__FILE__, __LINE__, "CHECK(" #condition ") failed");          \
+        }                                                                                          \
+    } while (false)
+
+#define CHECK_EQUAL(lhs, rhs)                                                                      \
+    do {                                                                                           \
+        const auto& lhs_value = (lhs);                                                             \
+        const auto& rhs_value = (rhs);                                                             \
+        if (!(lhs_value == rhs_value)) {                                                           \
+            std::ostringstream message;                                                            \
+            message << #lhs " != " #rhs ": " << lhs_value << " != " << rhs_value;                  \
+            ::testing::ReportFailure(__FILE__, __LINE__, message.str());                           \
+        }                                                                                          \
+    } while (false)
+
+#define CHECK_NEAR(lhs, rhs, tolerance)                                                            \
+    do {                                                                                           \
+        const double lhs_value = (lhs);                                                            \
+        const double rhs_value = (rhs);                                                            \
+        if (!(std::abs(lhs_value - rhs_value) <= (tolerance))) {                                   \
+            std::ostringstream message;                                                            \
+            message.precision(17);                                                                 \
+            message << #lhs " != " #rhs ": " << lhs_value << " != " << rhs_value;                  \
+            ::testing::ReportFailure(__FILE__, __LINE__, message.str());                           \
+        }                                                                                          \
+    } while (false)
+
+#define CHECK_THROWS(statement, exception)                                                         \
+    do {                                                                                           \
+        bool thrown = false;                                                                       \
+        try {                                                                                      \
+            statement;                                                                             \
+        } catch (const exception&) {                                                               \
+            thrown = true;                                                                         \
+        }                                                                                          \
+        if (!thrown) {                                                                             \
+            ::testing::ReportFailure(__FILE__, __LINE__, #statement " didn't throw " #exception);  \
+        }                                                                                          \
+    } while (false)
+
+#define RUN_TEST(test) ::testing::RunTest(test, #test)
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "geo.h"
+#include "request_handler.h"
+
+// A reproducible random network and the fastest times over it found by brute force, independently
+// of the catalogue and the router. No two buses share a pair of neighbouring stops and no bus visits
+// a stop twice, except the last stop of a circular bus, so equal-time alternatives hardly ever occur
+// and every engine should find the very same route.
+namespace testing {
+
+struct TestBus {
+    std::string name;
+    bool circular = false;
+    // Indices in TestNetwork::stop_names; a circular bus ends at its first stop.
+    std::vector<size_t> stops;
+};
+
+struct TestNetwork {
+    std::vector<std::string> stop_names;
+    std::vector<geo::Coordinates> coordinates;
+    // Road lengths in metres given for (from, to); the other direction falls back to them.
+    std::map<std::pair<size_t, size_t>, int> lengths;
+    std::vector<TestBus> buses;
+
+    int GetLength(size_t from, size_t to) const {
+        const auto it = lengths.find({ from, to });
+        return it != lengths.end() ? it->second : lengths.at({ to, from });
+    }
+};
+
+// Only the fully specified std::mt19937 is used, so every standard library generates the same network.
+inline TestNetwork GenerateNetwork(uint32_t seed, size_t stop_count, size_t bus_count) {
+    std::mt19937 rng(seed);
+    const auto uniform = [&rng](double from, double to) {
+        return from + (to - from) * (static_cast<double>(rng()) / static_cast<double>(std::mt19937::max()));
+    };
+
+    TestNetwork network;
+    for (size_t stop = 0; stop < stop_count; ++stop) {
+        network.stop_names.push_back("Stop " + std::to_string(stop));
+        network.coordinates.push_back({ uniform(55.60, 55.80), uniform(37.50, 37.70) });
+    }
+
+    // Roads are mostly longer than the straight line, but some are shorter, which A* has to cope with.
+    std::set<std::pair<size_t, size_t>> used_pairs;
+    const auto add_road = [&](size_t from, size_t to) {
+        used_pairs.insert({ std::min(from, to), std::max(from, to) });
+        const double straight = geo::ComputeDistance(network.coordinates[from], network.coordinates[to]);
+        switch (rng() % 3) {
+        case 0:
+            network.lengths[{ from, to }] = static_cast<int>(straight * uniform(0.9, 1.6)) + 1;
+            break;
+        case 1:
+            network.lengths[{ from, to }] = static_cast<int>(straight * uniform(0.9, 1.6)) + 1;
+            network.lengths[{ to, from }] = static_cast<int>(straight * uniform(0.9, 1.6)) + 1;
+            break;
+        default:
+            network.lengths[{ to, from }] = static_cast<int>(straight * uniform(0.9, 1.6)) + 1;
+            break;
+        }
+    };
+    const auto is_free = [&used_pairs](size_t from, size_t to) {
+        return from != to && used_pairs.count({ std::min(from, to), std::max(from, to) }) == 0;
+    };
+
+    while (network.buses.size() < bus_count) {
+        TestBus bus;
+        bus.name = "Bus " + std::to_string(network.buses.size());
+        bus.circular = rng() % 3 == 0;
+        bus.stops.push_back(rng() % stop_count);
+
+        const size_t wanted_size = 3 + rng() % 5;
+        for (size_t attempt = 0; attempt < 100 && bus.stops.size() < wanted_size; ++attempt) {
+            const size_t next = rng() % stop_count;
+            if (is_free(bus.stops.back(), next) && std::find(bus.stops.begin(), bus.stops.end(), next) == bus.stops.end()) {
+                add_road(bus.stops.back(), next);
+                bus.stops.push_back(next);
+            }
+        }
+        if (bus.stops.size() < 2) {
+            continue;
+        }
+        if (bus.circular) {
+            if (bus.stops.size() < 3 || !is_free(bus.stops.back(), bus.stops.front())) {
+                bus.circular = false;
+            } else {
+                add_road(bus.stops.back(), bus.stops.front());
+                bus.stops.push_back(bus.stops.front());
+            }
+        }
+        network.buses.push_back(std::move(bus));
+    }
+    return network;
+}
+
+inline catalogue_core::BusRouteRaw ToBusRouteRaw(const TestNetwork& network, const TestBus& bus) {
+    catalogue_core::BusRouteRaw output{ bus.circular, bus.name, {} };
+    for (const size_t stop : bus.stops) {
+        output.stops.push_back(network.stop_names[stop]);
+    }
+    return output;
+}
+
+// Loads the stops, the lengths and the buses with the given indices (all of them by default).
+inline void LoadNetwork(catalogue_core::RequestHandler& handler, const TestNetwork& network, std::vector<size_t> bus_indices = {}) {
+    if (bus_indices.empty()) {
+        for (size_t bus = 0; bus < network.buses.size(); ++bus) {
+            bus_indices.push_back(bus);
+        }
+    }
+    std::vector<catalogue_core::BusStopRaw> stops(network.stop_names.size());
+    for (size_t stop = 0; stop < stops.size(); ++stop) {
+        stops[stop].bus_stop.name = network.stop_names[stop];
+        stops[stop].bus_stop.coordinates = network.coordinates[stop];
+    }
+    for (const auto& [stops_pair, length] : network.lengths) {
+        stops[stops_pair.first].names.push_back(network.stop_names[stops_pair.second]);
+        stops[stops_pair.first].lengths.push_back(length);
+    }
+    for (const catalogue_core::BusStopRaw& stop : stops) {
+        handler.AddStopsToBuffer(stop);
+    }
+    for (const size_t bus : bus_indices) {
+        handler.AddRoutesToBuffer(ToBusRouteRaw(network, network.buses[bus]));
+    }
+    handler.LoadBufferToCatalogue();
+}
+
+// Minutes of a ride between two positions of the bus, as the router counts them.
+inline double GetRideTime(const TestNetwork& network, const TestBus& bus, size_t board_position, size_t alight_position, double bus_velocity) {
+    int distance = 0;
+    if (board_position < alight_position) {
+        for (size_t position = board_position; position < alight_position; ++position) {
+            distance += network.GetLength(bus.stops[position], bus.stops[position + 1]);
+        }
+    } else {
+        for (size_t position = alight_position; position < board_position; ++position) {
+            distance += network.GetLength(bus.stops[position + 1], bus.stops[position]);
+        }
+    }
+    return static_cast<double>(distance) / bus_velocity * (60.0 / 1000.0);
+}
+
+// Fastest times between all stops over the given buses by Floyd-Warshall, in minutes, infinite if unreachable.
+// Every ride from one position of a bus to a later one (or an earlier one for a non-circular bus) is an edge.
+inline std::vector<std::vector<double>> ComputeFastestTimes(const TestNetwork& network, const std::vector<size_t>& bus_indices,
+                                                            int bus_wait_time, double bus_velocity) {
+    const size_t stop_count = network.stop_names.size();
+    std::vector<std::vector<double>> times(stop_count, std::vector<double>(stop_count, std::numeric_limits<double>::infinity()));
+    for (size_t stop = 0; stop < stop_count; ++stop) {
+        times[stop][stop] = 0.0;
+    }
+
+    for (const size_t bus_index : bus_indices) {
+        const TestBus& bus = network.buses[bus_index];
+        for (size_t board = 0; board < bus.stops.size(); ++board) {
+            for (size_t alight = 0; alight < bus.stops.size(); ++alight) {
+                if (board == alight || (bus.circular && alight < board)) {
+                    continue;
+                }
+                double& time = times[bus.stops[board]][bus.stops[alight]];
+                time = std::min(time, bus_wait_time + GetRideTime(network, bus, board, alight, bus_velocity));
+            }
+        }
+    }
+
+    for (size_t through = 0; through < stop_count; ++through) {
+        for (size_t from = 0; from < stop_count; ++from) {
+            for (size_t to = 0; to < stop_count; ++to) {
+                times[from][to] = std::min(times[from][to], times[from][through] + times[through][to]);
+            }
+        }
+    }
+    return times;
+}
+
+}  // namespace testing
@@ -0,0 +1,179 @@
+// Distances and statistics that TransportCatalogue precomputes along its buses.
+
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "domain.h"
+#include "geo.h"
+#include "transport_catalogue.h"
+
+#include "test_framework.h"
+
+using namespace catalogue_core;
+
+namespace {
+
+// Four stops on a line, with road lengths A-B 1000 and B-A 1200, B-C 500 one way only, and no length for C-D.
+struct Fixture {
+    Fixture() {
+        for (const char* name : { "A", "B", "C", "D" }) {
+            stops.push_back(catalogue.AddBusStop({ name, { 55.60 + 0.01 * stops.size(), 37.60 }, 0 })->id);
+        }
+        catalogue.AddLength("A", { "B" }, { 1000 });
+        catalogue.AddLength("B", { "A", "C" }, { 1200, 500 });
+    }
+
+    domain::BusRoute* AddBus(const std::string& name, bool circular, const std::vector<size_t>& positions) {
+        domain::BusRoute route{ circular, name, {}, 0 };
+        for (const size_t position : positions) {
+            route.stops.push_back(stops[position]);
+        }
+        return catalogue.AddBusRoute(route);
+    }
+
+    transport_catalogue::TransportCatalogue catalogue;
+    std::vector<domain::StopId> stops;
+};
+
+void TestRoadPrefixSums() {
+    Fixture fixture;
+    const domain::BusRoute* route = fixture.AddBus("Line", false, { 0, 1, 2 });
+    fixture.catalogue.SetAllRoutes();
+
+    const domain::RouteDistances& distances = fixture.catalogue.GetRouteDistances(route->id);
+    CHECK(distances.road == std::vector<int>({ 0, 1000, 1500 }));
+    // C-B falls back to the length given for B-C.
+    CHECK(distances.road_back == std::vector<int>({ 0, 1200, 1700 }));
+}
+
+void TestLengthInvalidatesOnlyBusesThroughBothStops() {
+    Fixture fixture;
+    const domain::BusRoute* line = fixture.AddBus("Line", false, { 0, 1, 2 });
+    const domain::BusRoute* other = fixture.AddBus("Other", false, { 1, 0 });
+    fixture.catalogue.SetAllRoutes();
+
+    fixture.catalogue.AddLength("C", { "B" }, { 700 });
+    CHECK(fixture.catalogue.GetRouteDistances(line->id).road.empty());
+    CHECK_EQUAL(fixture.catalogue.GetRouteDistances(other->id).road.size(), 2u);
+
+    fixture.catalogue.SetAllRoutes();
+    CHECK(fixture.catalogue.GetRouteDistances(line->id).road_back == std::vector<int>({ 0, 1200, 1900 }));
+}
+
+// As the statistics always did, a circular bus skips a stretch of unknown length and any other bus throws.
+void TestUnknownLength() {
+    Fixture circular;
+    const domain::BusRoute* ring = circular.AddBus("Ring", true, { 1, 2, 3, 1 });
+    circular.catalogue.AddLength("D", { "B" }, { 300 });
+    circular.catalogue.SetAllRoutes();
+    CHECK(circular.catalogue.GetRouteDistances(ring->id).road == std::vector<int>({ 0, 500, 500, 800 }));
+
+    Fixture line;
+    line.AddBus("Line", false, { 1, 2, 3 });
+    CHECK_THROWS(line.catalogue.SetAllRoutes(), std::bad_optional_access);
+}
+
+using BusNames = std::set<std::string_view, std::less<>>;
+
+// Ids are dense in the order of adding, names are interned, and lookups by id and by name agree.
+void TestDenseIds() {
+    Fixture fixture;
+    for (size_t position = 0; position < fixture.stops.size(); ++position) {
+        CHECK_EQUAL(fixture.stops[position], position);
+        const domain::BusStop* stop = fixture.catalogue.FindBusStop(fixture.stops[position]);
+        CHECK(stop == fixture.catalogue.FindBusStop(stop->name));
+    }
+    CHECK(fixture.catalogue.FindBusStop(static_cast<domain::StopId>(fixture.stops.size())) == nullptr);
+
+    std::string name = "Line";
+    const domain::BusRoute* line = fixture.AddBus(name, false, { 0, 1 });
+    name = "Changed";
+    const domain::BusRoute* ring = fixture.AddBus("Ring", true, { 0, 1, 0 });
+    CHECK_EQUAL(line->id, 0u);
+    CHECK_EQUAL(ring->id, 1u);
+    CHECK_EQUAL(line->name, "Line");
+    CHECK(fixture.catalogue.FindBusRoute(line->id) == line);
+    CHECK(fixture.catalogue.FindBusRoute("Line") == line);
+
+    CHECK_EQUAL(fixture.catalogue.GetLength(fixture.stops[0], fixture.stops[1]).value_or(0), 1000);
+    CHECK_EQUAL(fixture.catalogue.GetLength(fixture.stops[2], fixture.stops[1]).value_or(0), 500);
+    CHECK(!fixture.catalogue.GetLength(fixture.stops[2], fixture.stops[3]).has_value());
+    CHECK(fixture.catalogue.GetInformationAboutStop(fixture.stops[0]) == BusNames({ "Line", "Ring" }));
+    CHECK(fixture.catalogue.GetInformationAboutStop(fixture.stops[3]).empty());
+
+    // A removed bus keeps its id unused, and a new one takes the next id.
+    const domain::BusId removed_id = line->id;
+    fixture.catalogue.RemoveBusRoute("Line");
+    CHECK(fixture.catalogue.FindBusRoute(removed_id) == nullptr);
+    CHECK(fixture.catalogue.FindBusRoute("Line") == nullptr);
+    CHECK(fixture.catalogue.GetInformationAboutStop(fixture.stops[0]) == BusNames({ "Ring" }));
+    CHECK_EQUAL(fixture.AddBus("Line", false, { 1, 2 })->id, 2u);
+}
+
+double ComputeGeoLength(const Fixture& fixture, const std::vector<size_t>& positions) {
+    double output = 0.0;
+    for (size_t i = 1; i < positions.size(); ++i) {
+        output += geo::ComputeDistance(fixture.catalogue.FindBusStop(fixture.stops[positions[i - 1]])->coordinates,
+                                       fixture.catalogue.FindBusStop(fixture.stops[positions[i]])->coordinates);
+    }
+    return output;
+}
+
+void TestRouteStatistics() {
+    Fixture fixture;
+    fixture.catalogue.AddLength("D", { "B" }, { 300 });
+    fixture.AddBus("Line", false, { 0, 1, 2 });
+    fixture.AddBus("Ring", true, { 1, 2, 3, 1 });
+    fixture.catalogue.SetAllRoutes();
+
+    const std::optional<domain::RouteStatistic> line = fixture.catalogue.GetInformationAboutBusRoute("Line");
+    CHECK(line.has_value());
+    if (line.has_value()) {
+        CHECK_EQUAL(line->num_of_stops_, 5);
+        CHECK_EQUAL(line->num_of_unique_stops_, 3);
+        CHECK_EQUAL(line->route_length_, 1500 + 1700);
+        CHECK_NEAR(line->curvature, 3200 / (2.0 * ComputeGeoLength(fixture, { 0, 1, 2 })), 1e-12);
+    }
+
+    const std::optional<domain::RouteStatistic> ring = fixture.catalogue.GetInformationAboutBusRoute("Ring");
+    CHECK(ring.has_value());
+    if (ring.has_value()) {
+        CHECK_EQUAL(ring->num_of_stops_, 4);
+        CHECK_EQUAL(ring->num_of_unique_stops_, 3);
+        CHECK_EQUAL(ring->route_length_, 800);
+        CHECK_NEAR(ring->curvature, 800 / ComputeGeoLength(fixture, { 1, 2, 3, 1 }), 1e-12);
+    }
+
+    CHECK(!fixture.catalogue.GetInformationAboutBusRoute("Unknown").has_value());
+}
+
+// A statistic read from a base is kept as it is instead of being computed again.
+void TestRestoredStatisticIsKept() {
+    Fixture fixture;
+    const domain::BusRoute* route = fixture.AddBus("Line", false, { 0, 1, 2 });
+    fixture.catalogue.SetRouteStatistic(route->id, { 5, 3, 42, 1.5 });
+    fixture.catalogue.SetAllRoutes();
+
+    const std::optional<domain::RouteStatistic> statistic = fixture.catalogue.GetInformationAboutBusRoute(route->id);
+    CHECK(statistic.has_value());
+    if (statistic.has_value()) {
+        CHECK_EQUAL(statistic->route_length_, 42);
+        CHECK_EQUAL(statistic->curvature, 1.5);
+    }
+    CHECK(fixture.catalogue.GetRouteDistances(route->id).road == std::vector<int>({ 0, 1000, 1500 }));
+}
+
+}  // namespace
+
+int main() {
+    RUN_TEST(TestDenseIds);
+    RUN_TEST(TestRoadPrefixSums);
+    RUN_TEST(TestLengthInvalidatesOnlyBusesThroughBothStops);
+    RUN_TEST(TestUnknownLength);
+    RUN_TEST(TestRouteStatistics);
+    RUN_TEST(TestRestoredStatisticIsKept);
+    return testing::Finish();
+}
@@ -3,6 +3,7 @@
 #include <stdexcept>
 
 #include "transport_catalogue.h"
+#include "parallel.h"
 
 namespace catalogue_core {
 
@@ -10,8 +11,6 @@ namespace transport_catalogue {
 
 using namespace domain;
 
-static const std::set<std::string_view, std::less<>> zeroset;
-
  const std::set<std::string_view, std::less<>>& TransportCatalogue::AllRoutesNames() const {
 	 return routes_names_;
  }
@@ -34,24 +33,75 @@ BusStop* TransportCatalogue::FindBusStop(const std::string_view busstop_name) co
 			}
 		}
 
+void TransportCatalogue::RemoveBusRoute(const std::string_view busroute_name) {
+
+	using namespace std::string_literals;
+
+	auto route_ptr = FindBusRoute(busroute_name);
+	if (route_ptr == nullptr) {
+		throw std::invalid_argument("RemoveBusRoute: Unknown bus route name"s);
+	}
+	for (const StopId stop : route_ptr->stops) {
+		buses_for_stop_[stop].erase(route_ptr->name);
+	}
+	routes_names_.erase(route_ptr->name);
+	busname_to_routes_.erase(route_ptr->name);
+	routes_by_id_[route_ptr->id] = nullptr;
+	if (route_ptr->id < route_distances_.size()) {
+		route_distances_[route_ptr->id] = RouteDistances();
+	}
+	if (route_ptr->id < route_statistics_.size()) {
+		route_statistics_[route_ptr->id].reset();
+	}
+	*route_ptr = BusRoute();
+	SetAllRoutes();
+}
+
 BusStop* TransportCatalogue::AddBusStop(const BusStop& bus_stop) {
-			auto it = bus_stops_.insert(bus_stops_.begin(), bus_stop);
-			stopname_to_stops_[it->name] = &(*it);
-			return  &(*it);
+			BusStop* ptr = &bus_stops_.Emplace(bus_stop);
+			ptr->name = names_.Intern(bus_stop.name);
+			ptr->id = static_cast<StopId>(stops_by_id_.size());
+			stops_by_id_.push_back(ptr);
+			buses_for_stop_.emplace_back();
+			stopname_to_stops_[ptr->name] = ptr;
+			return ptr;
 		}
 
 BusRoute* TransportCatalogue::AddBusRoute(const BusRoute& bus_route) {
-			auto ptr = bus_routes_.insert(bus_routes_.begin(), bus_route);
-			busname_to_routes_[ptr->name] = &(*ptr);
-			for (auto& stop : bus_route.stops) {
-				buses_for_stop_[stop->name].insert(ptr->name);
+			BusRoute* ptr = &bus_routes_.Emplace(bus_route);
+			ptr->name = names_.Intern(bus_route.name);
+			ptr->id = static_cast<BusId>(routes_by_id_.size());
+			routes_by_id_.push_back(ptr);
+			busname_to_routes_[ptr->name] = ptr;
+			for (const StopId stop : ptr->stops) {
+				buses_for_stop_.at(stop).insert(ptr->name);
 			}
 			routes_names_.insert(ptr->name);
 
-			return &(*ptr);
+			return ptr;
 		}
 
-void TransportCatalogue::AddLength(const std::string& bus_stop_name, const std::vector<std::string> names, const std::vector<int>& lengths) {
+void TransportCatalogue::Reserve(size_t stop_count, size_t route_count, size_t length_count) {
+	names_.Reserve(stop_count + route_count);
+	bus_stops_.Reserve(stop_count);
+	stops_by_id_.reserve(stops_by_id_.size() + stop_count);
+	buses_for_stop_.reserve(buses_for_stop_.size() + stop_count);
+	stopname_to_stops_.reserve(stopname_to_stops_.size() + stop_count);
+	bus_routes_.Reserve(route_count);
+	routes_by_id_.reserve(routes_by_id_.size() + route_count);
+	busname_to_routes_.reserve(busname_to_routes_.size() + route_count);
+	stop_lengths_.Reserve(length_count);
+}
+
+BusStop* TransportCatalogue::FindBusStop(StopId id) const {
+	return id < stops_by_id_.size() ? stops_by_id_[id] : nullptr;
+}
+
+BusRoute* TransportCatalogue::FindBusRoute(BusId id) const {
+	return id < routes_by_id_.size() ? routes_by_id_[id] : nullptr;
+}
+
+void TransportCatalogue::AddLength(std::string_view bus_stop_name, const std::vector<std::string>& names, const std::vector<int>& lengths) {
 
 	using namespace std::string_literals;
 
@@ -59,7 +109,7 @@ void TransportCatalogue::AddLength(const std::string& bus_stop_name, const std::
 
 		for (size_t i = 0; i < names.size(); ++i) {
 			if (auto second_ptr = FindBusStop(names[i]); second_ptr != nullptr) {
-				stop_lengths_[std::make_pair(first_ptr, second_ptr)] = lengths[i];
+				AddLengthByPtr(first_ptr, second_ptr, lengths[i]);
 			}
 			else {
 				throw std::invalid_argument("AddLength: Unknown second bus stop name"s);
@@ -72,98 +122,103 @@ void TransportCatalogue::AddLength(const std::string& bus_stop_name, const std::
 }
 
 void TransportCatalogue::AddLengthByPtr(const BusStop* first_stop, const BusStop* second_stop, int length) {
-	stop_lengths_[std::make_pair(const_cast<BusStop*>(first_stop), const_cast<BusStop*>(second_stop))] = length;
+	stop_lengths_.Set(first_stop->id, second_stop->id, length);
+	// Only the buses through both stops may ride between them; the next SetAllRoutes recomputes them.
+	const auto& second_buses = buses_for_stop_[second_stop->id];
+	for (const std::string_view bus_name : buses_for_stop_[first_stop->id]) {
+		if (second_buses.count(bus_name) == 0) {
+			continue;
+		}
+		const BusId id = busname_to_routes_.at(bus_name)->id;
+		if (id < route_distances_.size()) {
+			route_distances_[id] = RouteDistances();
+		}
+		if (id < route_statistics_.size()) {
+			route_statistics_[id].reset();
+		}
+	}
 }
 
 std::optional<int> TransportCatalogue::GetLength(const std::string& stop_name_first, const std::string& stop_name_second) const {
-			
+	return GetLength(stopname_to_stops_.at(stop_name_first)->id, stopname_to_stops_.at(stop_name_second)->id);
+}
 
-			if (auto pair_stops = std::make_pair(stopname_to_stops_.at(stop_name_first), stopname_to_stops_.at(stop_name_second)); stop_lengths_.count(pair_stops)) {
-				return  stop_lengths_.at(pair_stops);
-			}
-			else if (auto pair_stops = std::make_pair(stopname_to_stops_.at(stop_name_second), stopname_to_stops_.at(stop_name_first)); stop_lengths_.count(pair_stops)) {
-				return  stop_lengths_.at(pair_stops);
-			}
-			else {
-				return std::nullopt;
-			}
-		}
+std::optional<int> TransportCatalogue::GetLength(StopId first_stop, StopId second_stop) const {
+	return stop_lengths_.Get(first_stop, second_stop);
+}
 
-std::optional<domain::RouteStatistic> TransportCatalogue::GetInformationAboutBusRoute(const std::string& busroute_name) const {
+std::optional<int> TransportCatalogue::GetLength(const BusStop* first_stop, const BusStop* second_stop) const {
+	return stop_lengths_.Get(first_stop->id, second_stop->id);
+}
 
-	domain::RouteStatistic output;
+std::optional<domain::RouteStatistic> TransportCatalogue::GetInformationAboutBusRoute(const std::string& busroute_name) const {
+	if (const auto it = busname_to_routes_.find(busroute_name); it != busname_to_routes_.end()) {
+		return GetInformationAboutBusRoute(it->second->id);
+	}
+	return std::nullopt;
+}
 
-	if (busname_to_routes_.count(busroute_name) == 0) {
+std::optional<domain::RouteStatistic> TransportCatalogue::GetInformationAboutBusRoute(BusId id) const {
+	if (id >= route_statistics_.size()) {
 		return std::nullopt;
 	}
+	return route_statistics_[id];
+}
 
-	auto route_ptr = busname_to_routes_.at(busroute_name);
-
-	output.route_length_ = 0;
-	output.curvature = 0.0;
-	std::unordered_set<std::string_view> route;
-
-	if (!route_ptr->circular) {
-		for (auto first = route_ptr->stops.begin(); first != route_ptr->stops.end() - 1; ++first) {
-			route.insert((*first)->name);
+void TransportCatalogue::SetRouteStatistic(BusId id, const domain::RouteStatistic& statistic) {
+	if (id >= route_statistics_.size()) {
+		route_statistics_.resize(id + 1);
+	}
+	route_statistics_[id] = statistic;
+}
 
-			auto len_forward = GetLength((*first)->name, (*(first + 1))->name);
-			auto len_backward = GetLength((*(first + 1))->name, (*first)->name);
+domain::RouteStatistic TransportCatalogue::ComputeRouteStatistic(const BusRoute& route) const {
 
-			if (len_forward.has_value() && len_backward.has_value()) {
-				output.route_length_ += len_forward.value() + len_backward.value();
-			}
-			else if (len_forward.has_value()) {
-				output.route_length_ += 2 * len_forward.value();
-			}
-			else {
-				output.route_length_ += 2 * len_backward.value();
-			}
+	domain::RouteStatistic output;
 
-			output.curvature += ComputeDistance(stopname_to_stops_.at((*first)->name)->coordinates,
-				stopname_to_stops_.at((*(first + 1))->name)->coordinates);
+	const RouteDistances& distances = route_distances_[route.id];
+	std::unordered_set<StopId> unique_stops;
+	double geo_length = 0.0;
+	for (size_t i = 0; i < route.stops.size(); ++i) {
+		unique_stops.insert(route.stops[i]);
+		if (i > 0) {
+			geo_length += ComputeDistance(stops_by_id_[route.stops[i - 1]]->coordinates, stops_by_id_[route.stops[i]]->coordinates);
 		}
-		output.curvature *= 2.0;
-		output.num_of_stops_ = static_cast<int>(2 * route_ptr->stops.size()) - 1;
 	}
-	else {
-		for (auto first = route_ptr->stops.begin(); first != route_ptr->stops.end() - 1; ++first) {
-			route.insert((*first)->name);
 
-			if (auto len = GetLength((*first)->name, (*(first + 1))->name); len.has_value()) {
-				output.route_length_ += len.value();
-			}
-			else if (auto len = GetLength((*(first + 1))->name, (*first)->name); len.has_value()) {
-				output.route_length_ += len.value();
-			}
-
-			output.curvature += ComputeDistance(stopname_to_stops_.at((*first)->name)->coordinates,
-												stopname_to_stops_.at((*(first + 1))->name)->coordinates);
-		}
-		output.num_of_stops_ = static_cast<int>(route_ptr->stops.size());
+	if (!route.circular) {
+		output.route_length_ = distances.road.back() + distances.road_back.back();
+		output.curvature = 2.0 * geo_length;
+		output.num_of_stops_ = static_cast<int>(2 * route.stops.size()) - 1;
+	}
+	else {
+		output.route_length_ = distances.road.back();
+		output.curvature = geo_length;
+		output.num_of_stops_ = static_cast<int>(route.stops.size());
 	}
 
 	output.curvature = static_cast<double>(output.route_length_) / output.curvature;
-	route.insert((*(route_ptr->stops.end() - 1))->name);
-	output.num_of_unique_stops_ = static_cast<int>(route.size());
+	output.num_of_unique_stops_ = static_cast<int>(unique_stops.size());
 
 	return output;
 }
 
 std::optional<std::set<std::string_view, std::less<>>> TransportCatalogue::GetInformationAboutStop(const std::string& stop_name) const {
-	if (stopname_to_stops_.count(stop_name) == 0) {
-		return std::nullopt;
-	}
-	if (buses_for_stop_.count(stop_name)) {
-		return buses_for_stop_.at(stop_name);
-	}
-	else {
-		return zeroset;
+	if (const auto it = stopname_to_stops_.find(stop_name); it != stopname_to_stops_.end()) {
+		return buses_for_stop_[it->second->id];
 	}
+	return std::nullopt;
+}
+
+const std::set<std::string_view, std::less<>>& TransportCatalogue::GetInformationAboutStop(StopId id) const {
+	return buses_for_stop_.at(id);
 }
 
 
-void TransportCatalogue::SetAllRoutes() {
+void TransportCatalogue::SetAllRoutes(size_t thread_count) {
+
+	// Fewer stale buses take less time than starting the threads.
+	static constexpr size_t MIN_PARALLEL_ROUTE_COUNT = 256;
 
 	all_routes_.clear();
 	num_stops_by_bus_ = 0;
@@ -171,6 +226,46 @@ void TransportCatalogue::SetAllRoutes() {
 		all_routes_.push_back(FindBusRoute(route_name));
 		num_stops_by_bus_ += all_routes_.back()->stops.size();
 	}
+
+	route_distances_.resize(routes_by_id_.size());
+	route_statistics_.resize(routes_by_id_.size());
+
+	// Distances are dropped when a length on the bus changes, so a size mismatch marks them stale.
+	std::vector<const BusRoute*> stale_routes;
+	for (const BusRoute* route : all_routes_) {
+		if (route_distances_[route->id].road.size() != route->stops.size() || !route_statistics_[route->id].has_value()) {
+			stale_routes.push_back(route);
+		}
+	}
+
+	parallel::ForEachIndex(stale_routes.size(), stale_routes.size() < MIN_PARALLEL_ROUTE_COUNT ? 1 : thread_count, [this, &stale_routes](size_t index) {
+		const BusRoute& route = *stale_routes[index];
+		if (route_distances_[route.id].road.size() != route.stops.size()) {
+			ComputeRouteDistances(route);
+		}
+		if (!route_statistics_[route.id].has_value()) {
+			route_statistics_[route.id] = ComputeRouteStatistic(route);
+		}
+	});
+}
+
+void TransportCatalogue::ComputeRouteDistances(const BusRoute& route) {
+	RouteDistances& distances = route_distances_[route.id];
+	const auto& stops = route.stops;
+	distances.road.assign(stops.size(), 0);
+	distances.road_back.assign(stops.size(), 0);
+	for (size_t i = 1; i < stops.size(); ++i) {
+		const std::optional<int> length = GetLength(stops[i - 1], stops[i]);
+		const std::optional<int> length_back = GetLength(stops[i], stops[i - 1]);
+		// A circular bus skips a stretch of unknown length, as its statistics always have;
+		// on any other bus it throws std::bad_optional_access.
+		distances.road[i] = distances.road[i - 1] + (route.circular ? length.value_or(0) : length.value());
+		distances.road_back[i] = distances.road_back[i - 1] + (route.circular ? length_back.value_or(0) : length_back.value());
+	}
+}
+
+const RouteDistances& TransportCatalogue::GetRouteDistances(BusId id) const {
+	return route_distances_.at(id);
 }
 
 const std::vector<domain::BusRoute*>& TransportCatalogue::GetAllRoutes() const {
@@ -186,16 +281,11 @@ size_t TransportCatalogue::GetNumStopsByBus() const {
 	return num_stops_by_bus_;
  }
  
- std::vector<const domain::BusStop*> TransportCatalogue::GetAllStops() const {
-	 std::vector<const domain::BusStop*> output;
-	 output.reserve(bus_stops_.size());
-	 for (auto& stop : bus_stops_) {
-		 output.push_back(&stop);
-	 }
-	return output;
+ ranges::Range<std::vector<domain::BusStop*>::const_reverse_iterator> TransportCatalogue::GetAllStops() const {
+	return { stops_by_id_.rbegin(), stops_by_id_.rend() };
 }
 
- const std::unordered_map<std::pair<domain::BusStop*, domain::BusStop*>, int, domain::StopLengthsHasher>& TransportCatalogue::GetAllLengths() const {
+ const DistanceTable& TransportCatalogue::GetAllLengths() const {
 	 return stop_lengths_;
  }
 
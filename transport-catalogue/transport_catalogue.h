@@ -1,12 +1,14 @@
 #pragma once
 
-#include<list>
 #include<string>
 #include<vector>
 #include<set>
 #include<unordered_map>
 #include <optional> 
 
+#include "arena.h"
+#include "distance_table.h"
+#include "ranges.h"
 #include "domain.h"
 
 namespace catalogue_core {
@@ -20,37 +22,73 @@ public:
 
 	[[nodiscard]] domain::BusRoute* AddBusRoute(const domain::BusRoute& bus_route);
 	[[nodiscard]] domain::BusStop* AddBusStop(const domain::BusStop& bus_stop);
+	// Makes room for that many more stops, buses and road lengths, so a bulk load allocates them at once.
+	void Reserve(size_t stop_count, size_t route_count, size_t length_count = 0);
+	// Forgets the bus and refreshes GetAllRoutes; pointers to the bus become dangling.
+	void RemoveBusRoute(const std::string_view busroute_name);
 
-	void AddLength(const std::string& bus_stop_name, const std::vector<std::string>names, const std::vector<int>& lengths);
+	void AddLength(std::string_view bus_stop_name, const std::vector<std::string>& names, const std::vector<int>& lengths);
 	void AddLengthByPtr(const domain::BusStop* first_stop, const domain::BusStop* second_stop, int length);
 
 	domain::BusRoute* FindBusRoute(const std::string_view busroute_name) const;
 	domain::BusStop* FindBusStop(const std::string_view busstop_name) const;
+	// By the handles the catalogue gives on adding; nullptr for unknown ones and removed buses.
+	domain::BusRoute* FindBusRoute(domain::BusId id) const;
+	domain::BusStop* FindBusStop(domain::StopId id) const;
 	const std::set<std::string_view, std::less<>>& AllRoutesNames() const;
 
+	// The road length from the first stop to the second one, or else from the second one to the first.
 	std::optional<int> GetLength(const std::string& stop_name_first, const std::string& stop_name_second) const;
+	std::optional<int> GetLength(const domain::BusStop* first_stop, const domain::BusStop* second_stop) const;
+	std::optional<int> GetLength(domain::StopId first_stop, domain::StopId second_stop) const;
+	// Statistics are computed by SetAllRoutes, so a query is a lookup.
 	std::optional<domain::RouteStatistic> GetInformationAboutBusRoute(const std::string& busroute_name) const;
+	std::optional<domain::RouteStatistic> GetInformationAboutBusRoute(domain::BusId id) const;
+	// Restores a statistic stored in a base; SetAllRoutes keeps it instead of computing it again.
+	void SetRouteStatistic(domain::BusId id, const domain::RouteStatistic& statistic);
 	std::optional<std::set<std::string_view, std::less<>>> GetInformationAboutStop(const std::string& busroute_name) const;
+	// Names of the buses through a known stop, without copying them.
+	const std::set<std::string_view, std::less<>>& GetInformationAboutStop(domain::StopId id) const;
 
-	void SetAllRoutes();
+	// Refreshes GetAllRoutes, then the distances and statistics of the buses that are new or pass
+	// a length added since; call it once the lengths are added. Enough such buses are split
+	// between thread_count threads (0 means one per core).
+	void SetAllRoutes(size_t thread_count = 1);
 	const std::vector<domain::BusRoute*>& GetAllRoutes() const;
-	 std::vector<const domain::BusStop*> GetAllStops() const;
-	const std::unordered_map<std::pair<domain::BusStop*, domain::BusStop*>, int, domain::StopLengthsHasher>& GetAllLengths() const;
+	// An unknown road length counts as zero on a circular bus; SetAllRoutes throws for any other bus.
+	const domain::RouteDistances& GetRouteDistances(domain::BusId id) const;
+	// Stops from the last added to the first, as they have always been listed: the graph vertices
+	// and the tie-breaking between equal routes follow this order.
+	ranges::Range<std::vector<domain::BusStop*>::const_reverse_iterator> GetAllStops() const;
+	const DistanceTable& GetAllLengths() const;
 	 size_t GetNumStops() const;
 	 size_t GetNumStopsByBus() const;
 
 private:
-	std::list<domain::BusStop> bus_stops_;
+	void ComputeRouteDistances(const domain::BusRoute& route);
+	domain::RouteStatistic ComputeRouteStatistic(const domain::BusRoute& route) const;
+
+	// Every stop and bus name is stored here once; the rest of the catalogue keeps views of them.
+	arena::StringPool names_;
+
+	arena::ChunkedArena<domain::BusStop> bus_stops_;
+	std::vector<domain::BusStop*> stops_by_id_;
 	std::unordered_map<std::string_view, domain::BusStop*> stopname_to_stops_;
 
-	std::list<domain::BusRoute> bus_routes_;
+	// A removed bus keeps its slot, emptied, until the catalogue is destroyed.
+	arena::ChunkedArena<domain::BusRoute> bus_routes_;
+	std::vector<domain::BusRoute*> routes_by_id_;
 	std::unordered_map<std::string_view, domain::BusRoute*> busname_to_routes_;
 	std::set<std::string_view, std::less<>> routes_names_;
 
-	std::unordered_map<std::string_view, std::set<std::string_view, std::less<>>> buses_for_stop_;
-	std::unordered_map<std::pair<domain::BusStop*, domain::BusStop*>, int, domain::StopLengthsHasher> stop_lengths_;
+	// Indexed by StopId.
+	std::vector<std::set<std::string_view, std::less<>>> buses_for_stop_;
+	DistanceTable stop_lengths_;
 
 	std::vector<domain::BusRoute*> all_routes_;
+	// Indexed by BusId.
+	std::vector<domain::RouteDistances> route_distances_;
+	std::vector<std::optional<domain::RouteStatistic>> route_statistics_;
 	size_t num_stops_by_bus_;
 		};
 	}
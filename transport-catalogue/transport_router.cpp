@@ -1,108 +1,572 @@
 #include <unordered_map>
 #include "transport_router.h"
+#include "parallel.h"
 #include <iostream>
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <cmath>
+#include <type_traits>
+#include <set>
+#include <stdexcept>
 
 namespace catalogue_core {
 	namespace router {
+		using namespace std::string_literals;
+
 		constexpr double DIMENSION = 60.0 / 1000.0;
+		// Keeps the geographic lower bound below the ride time despite rounding in ComputeDistance.
+		constexpr double HEURISTIC_MARGIN = 1.0 - 1e-9;
+
+		RouteWeight ToRouteWeight(double minutes) {
+			if constexpr (std::is_integral_v<RouteWeight>) {
+				return static_cast<RouteWeight>(std::llround(minutes * ROUTE_WEIGHT_UNITS_PER_MINUTE));
+			}
+			else {
+				return minutes;
+			}
+		}
+
+		double ToMinutes(RouteWeight weight) {
+			return static_cast<double>(weight) / ROUTE_WEIGHT_UNITS_PER_MINUTE;
+		}
+
+		template <typename Callback>
+		void TransportRouter::ForEachRideEdge(const domain::BusRoute* route, uint32_t bus, Callback&& callback) const {
+			const double board_time = router_settings_.fold_wait_edges ? static_cast<double>(router_settings_.bus_wait_time) : 0.0;
+			const auto end_stop = static_cast<uint32_t>(route->stops.size());
+
+			const domain::RouteDistances& distances = cat_.GetRouteDistances(route->id);
+
+			// The vertices of every stop are looked up once, not once per pair of stops.
+			std::vector<Exchange> vertices;
+			vertices.reserve(end_stop);
+			for (const domain::StopId stop : route->stops) {
+				vertices.push_back(bus_stop_to_vertex_.at(cat_.FindBusStop(stop)));
+			}
+
+			for (uint32_t first_stop = 0; first_stop + 1 < end_stop; first_stop++) {
+
+				const Exchange& first_vertex = vertices[first_stop];
+
+				for (uint32_t second_stop = first_stop+1; second_stop < end_stop; second_stop++) {
+
+					const Exchange& second_vertex = vertices[second_stop];
+
+					callback({ first_vertex.bus_vertex,	//    
+									second_vertex.interface_vertex,
+									ToRouteWeight(board_time + GetRideTime(distances, first_stop, second_stop)) }, EdgeContent{ bus, first_stop, second_stop });
+
+					if (!route->circular) {
+						callback({ second_vertex.bus_vertex,	//    
+										first_vertex.interface_vertex,
+										ToRouteWeight(board_time + GetRideTime(distances, second_stop, first_stop)) }, EdgeContent{ bus, second_stop, first_stop });
+					}
+				}
+			}
+		}
+
+		double TransportRouter::GetRideTime(const domain::RouteDistances& distances, uint32_t board_position, uint32_t alight_position) const {
+			const int distance = board_position < alight_position ? distances.road[alight_position] - distances.road[board_position]
+																  : distances.road_back[board_position] - distances.road_back[alight_position];
+			return static_cast<double>(distance) / router_settings_.bus_velocity * DIMENSION;
+		}
+
+		// Of equal weight, the edge given first is kept when the router is built: the edge of the bus that comes
+		// first in GetAllRoutes, that is by name, and the earlier edge of one bus. Updates keep the same one.
+		bool TransportRouter::PrefersRideEdge(RouteWeight weight, uint32_t bus, RouteWeight kept_weight, uint32_t kept_bus) const {
+			if (weight < kept_weight || kept_weight < weight) {
+				return weight < kept_weight;
+			}
+			return bus != kept_bus && buses_[bus]->name < buses_[kept_bus]->name;
+		}
+
+		uint32_t TransportRouter::FindBus(const domain::BusRoute* route) const {
+			const auto it = std::find(buses_.begin(), buses_.end(), route);
+			return it == buses_.end() ? EdgeContent::NO_BUS : static_cast<uint32_t>(it - buses_.begin());
+		}
+
+		// The wait edge and, with folded wait edges, the ride edge start at the interface vertex of their stop.
+		// The ride time comes from the distances along the bus, not from the edge weight, which may be rounded.
+		RoutePart TransportRouter::GetRoutePart(graph::EdgeId edge_id) const {
+			const EdgeContent& content = edges_content_[edge_id];
+			const auto& edge = graph_.GetEdge(edge_id);
+			if (content.bus == EdgeContent::NO_BUS) {
+				return { WaitOrBus::WAIT, "", interface_vertex_to_stop_[edge.from]->name, router_settings_.bus_wait_time, 0, 0 };
+			}
+			const domain::BusRoute* bus = buses_[content.bus];
+			const double bus_time = GetRideTime(cat_.GetRouteDistances(bus->id), content.board_position, content.alight_position);
+			const int span_count = static_cast<int>(std::max(content.board_position, content.alight_position) - std::min(content.board_position, content.alight_position));
+			return { WaitOrBus::BUS, bus->name, router_settings_.fold_wait_edges ? interface_vertex_to_stop_[edge.from]->name : "", 0, bus_time, span_count };
+		}
+
+		double TransportRouter::GetEdgeTime(graph::EdgeId edge_id) const {
+			const RoutePart part = GetRoutePart(edge_id);
+			if (part.wait_or_bus == WaitOrBus::WAIT) {
+				return static_cast<double>(part.wait_time);
+			}
+			return (router_settings_.fold_wait_edges ? static_cast<double>(router_settings_.bus_wait_time) : 0.0) + part.bus_time;
+		}
+
+		uint64_t TransportRouter::GetEndsKey(const graph::Edge<RouteWeight>& edge) const {
+			return static_cast<uint64_t>(edge.from) * graph_.GetVertexCount() + edge.to;
+		}
 
 		TransportRouter::TransportRouter(const RouterSettings& settings, catalogue_core::transport_catalogue::TransportCatalogue& cat)
 			: cat_(cat)
 			, router_settings_(settings)
-			, graph_(graph::DirectedWeightedGraph<double>(2 * cat_.GetNumStops())){
+			, graph_(graph::DirectedWeightedGraph<RouteWeight>(settings.engine == RouterEngine::RAPTOR ? 0 : (settings.fold_wait_edges ? 1 : 2) * cat_.GetNumStops())){
+
+			if (router_settings_.engine == RouterEngine::RAPTOR) {
+				graph_.Freeze();
+				CreateRaptorRouter();
+				return;
+			}
 
-			edges_content_.reserve(40 * cat_.GetNumStopsByBus());
 			graph::VertexId in = 0;
 
-			for (const auto& stop : cat_.GetAllStops()) {
+			for (const domain::BusStop* stop : cat_.GetAllStops()) {
 
+				if (router_settings_.fold_wait_edges) {
+					bus_stop_to_vertex_[stop] = { in, in };
+					++in;
+					continue;
+				}
 				bus_stop_to_vertex_[stop].interface_vertex = in;
 				bus_stop_to_vertex_[stop].bus_vertex = in+1;
 
 				graph_.AddEdge({ in,	//    
 								in+1,
-								static_cast<double>(router_settings_.bus_wait_time) });
-				edges_content_.push_back( { WaitOrBus::WAIT,
-												"",
-											stop->name,
-											router_settings_.bus_wait_time,
-											0 ,
-											0 });
+								ToRouteWeight(router_settings_.bus_wait_time) });
+				edges_content_.push_back({});
 				in += 2;
 			}
 			
-			for (auto& route:cat_.GetAllRoutes()) {
-				size_t end_stop =route->stops.size();
-
-				for (size_t first_stop = 0; first_stop < end_stop - 1; first_stop++) {
-					int time_forward = 0;
-					int time_reverse = 0;
-					int span_count = 0;
-
-					auto first_vertex = bus_stop_to_vertex_[route->stops[first_stop]];
-
-					for (size_t second_stop = first_stop+1; second_stop < end_stop; second_stop++) {
-
-						auto second_vertex = bus_stop_to_vertex_[route->stops[second_stop]];
-
-						time_forward += cat_.GetLength(route->stops[second_stop-1]->name, route->stops[second_stop]->name).value() ;
-
-						graph_.AddEdge({ first_vertex.bus_vertex,	//    
-													second_vertex.interface_vertex,
-													static_cast<double>(time_forward) / router_settings_.bus_velocity * DIMENSION });
-						RoutePart part = { WaitOrBus::BUS,
-										  route->name,
-										  "",
-										  0,
-										  static_cast<double>(time_forward) / router_settings_.bus_velocity * DIMENSION ,
-										  ++span_count };
-						edges_content_.push_back(part);
-
-						if (!route->circular) {
-							time_reverse += cat_.GetLength(route->stops[second_stop]->name, route->stops[second_stop - 1]->name).value();
-							graph_.AddEdge({ second_vertex.bus_vertex,	//    
-													    first_vertex.interface_vertex,
-														static_cast<double>(time_reverse) / router_settings_.bus_velocity * DIMENSION });
-							part.bus_time = static_cast<double>(time_reverse) / router_settings_.bus_velocity * DIMENSION;
-							edges_content_.push_back(part);
+			// Buses sharing a stretch of stops give parallel ride edges; only the lightest one per
+			// pair of vertices is kept (see PrefersRideEdge for the equal ones).
+			std::vector<graph::Edge<RouteWeight>> ride_edges;
+			std::vector<EdgeContent> ride_contents;
+			std::unordered_map<uint64_t, size_t> ride_edge_by_ends;
+			const auto add_ride_edge = [&](const graph::Edge<RouteWeight>& edge, const EdgeContent& content) {
+				if (edge.from == edge.to) {
+					return;
+				}
+				const auto [it, inserted] = ride_edge_by_ends.emplace(GetEndsKey(edge), ride_edges.size());
+				if (inserted) {
+					ride_edges.push_back(edge);
+					ride_contents.push_back(content);
+				}
+				else if (PrefersRideEdge(edge.weight, content.bus, ride_edges[it->second].weight, ride_contents[it->second].bus)) {
+					ride_edges[it->second] = edge;
+					ride_contents[it->second] = content;
+				}
+			};
+
+			// Routes give their ride edges independently, so they are generated on precompute_threads
+			// workers and merged in the order of the routes: edge ids don't depend on the thread count.
+			using RideEdges = std::vector<std::pair<graph::Edge<RouteWeight>, EdgeContent>>;
+			buses_.assign(cat_.GetAllRoutes().begin(), cat_.GetAllRoutes().end());
+			std::vector<RideEdges> route_ride_edges(buses_.size());
+			parallel::ForEachIndex(buses_.size(), router_settings_.precompute_threads, [this, &route_ride_edges](size_t index) {
+				RideEdges& output = route_ride_edges[index];
+				ForEachRideEdge(buses_[index], static_cast<uint32_t>(index), [&output](const graph::Edge<RouteWeight>& edge, const EdgeContent& content) {
+					output.emplace_back(edge, content);
+				});
+			});
+			for (RideEdges& route_edges : route_ride_edges) {
+				for (const auto& [edge, content] : route_edges) {
+					add_ride_edge(edge, content);
+				}
+				RideEdges().swap(route_edges);
+			}
+			for (const auto& edge : ride_edges) {
+				graph_.AddEdge(edge);
+			}
+			edges_content_.reserve(edges_content_.size() + ride_contents.size());
+			edges_content_.insert(edges_content_.end(), ride_contents.begin(), ride_contents.end());
+			graph_.Freeze();
+			router_ = CreateRouteBuilder();
+			InitializeReachability();
+
+		}
+
+		std::unique_ptr<graph::RouteBuilder<RouteWeight>> TransportRouter::CreateRouteBuilder() {
+			switch (router_settings_.engine) {
+			case RouterEngine::DIJKSTRA:
+				return std::make_unique<graph::DijkstraRouter<RouteWeight>>(graph_);
+			case RouterEngine::CONTRACTION_HIERARCHY:
+				return std::make_unique<graph::ContractionHierarchy<RouteWeight>>(graph_);
+			case RouterEngine::BIDIRECTIONAL_DIJKSTRA:
+				return std::make_unique<graph::BidirectionalDijkstraRouter<RouteWeight>>(graph_);
+			case RouterEngine::A_STAR:
+				return std::make_unique<graph::AStarRouter<RouteWeight>>(graph_, CreateGeoHeuristic());
+			case RouterEngine::HUB_LABELS:
+				return std::make_unique<graph::HubLabels<RouteWeight>>(graph_);
+			case RouterEngine::ALT:
+				landmarks_ = std::make_shared<graph::Landmarks<RouteWeight>>(graph_, router_settings_.landmark_count, router_settings_.precompute_threads);
+				return std::make_unique<graph::AStarRouter<RouteWeight>>(graph_, CreateLandmarkHeuristic());
+			default:
+				if (!router_settings_.parallel_precompute) {
+					return std::make_unique<graph::Router<RouteWeight>>(graph_);
+				}
+				graph::Router<RouteWeight>::ParallelBuild parallel_build;
+				parallel_build.thread_count = router_settings_.precompute_threads;
+				if (router_settings_.report_progress) {
+					parallel_build.progress = [](size_t rows_done, size_t rows_total) {
+						if ((100 * rows_done / rows_total) != (100 * (rows_done - 1) / rows_total)) {
+							std::cerr << "Router precompute: "s << 100 * rows_done / rows_total << "%"s << std::endl;
 						}
+					};
+				}
+				return std::make_unique<graph::Router<RouteWeight>>(graph_, parallel_build);
+			}
+		}
+
+		void TransportRouter::CreateRaptorRouter() {
+			raptor_router_ = std::make_unique<RaptorRouter>(cat_, router_settings_.bus_wait_time, DIMENSION / router_settings_.bus_velocity);
+		}
+
+		// Lower bound of the riding time between two vertices: the great-circle distance between their stops
+		// scaled by the least road/geo ratio over all ride segments (roads may be "shorter" than the
+		// great circle in the input), so the bound never exceeds the real time.
+		graph::AStarRouter<RouteWeight>::Heuristic TransportRouter::CreateGeoHeuristic() {
+			double min_ratio = 1.0;
+			for (const auto& route : cat_.GetAllRoutes()) {
+				min_ratio = std::min(min_ratio, GetRoadToGeoRatio(*route));
+			}
+			geo_heuristic_ratio_ = min_ratio;
+			const double units_per_meter = std::max(min_ratio, 0.0) * HEURISTIC_MARGIN / router_settings_.bus_velocity * DIMENSION
+										   * ROUTE_WEIGHT_UNITS_PER_MINUTE;
+
+			auto vertex_coordinates = std::make_shared<std::vector<geo::Coordinates>>(graph_.GetVertexCount());
+			for (const auto& [stop, exchange] : bus_stop_to_vertex_) {
+				(*vertex_coordinates)[exchange.interface_vertex] = stop->coordinates;
+				(*vertex_coordinates)[exchange.bus_vertex] = stop->coordinates;
+			}
+
+			// Fixed-point bounds are rounded down, so they stay below the weights rounded to the nearest unit.
+			return [vertex_coordinates, units_per_meter](graph::VertexId from, graph::VertexId to) -> RouteWeight {
+				const double bound = geo::ComputeDistance((*vertex_coordinates)[from], (*vertex_coordinates)[to]) * units_per_meter;
+				if constexpr (std::is_integral_v<RouteWeight>) {
+					return static_cast<RouteWeight>(std::floor(bound));
+				}
+				else {
+					return bound;
+				}
+			};
+		}
+
+		double TransportRouter::GetRoadToGeoRatio(const domain::BusRoute& route) const {
+			double min_ratio = 1.0;
+			const domain::RouteDistances& distances = cat_.GetRouteDistances(route.id);
+			for (size_t i = 1; i < route.stops.size(); ++i) {
+				const double geo_length = geo::ComputeDistance(cat_.FindBusStop(route.stops[i - 1])->coordinates,
+															   cat_.FindBusStop(route.stops[i])->coordinates);
+				if (geo_length == 0.0) {
+					continue;
+				}
+				min_ratio = std::min(min_ratio, (distances.road[i] - distances.road[i - 1]) / geo_length);
+				if (!route.circular) {
+					min_ratio = std::min(min_ratio, (distances.road_back[i] - distances.road_back[i - 1]) / geo_length);
+				}
+			}
+			return min_ratio;
+		}
+
+		graph::AStarRouter<RouteWeight>::Heuristic TransportRouter::CreateLandmarkHeuristic() const {
+			if (landmarks_ == nullptr) {
+				throw std::logic_error("CreateLandmarkHeuristic: landmarks aren't built"s);
+			}
+			return [landmarks = landmarks_](graph::VertexId from, graph::VertexId to) {
+				return landmarks->GetLowerBound(from, to);
+			};
+		}
+
+		std::unordered_map<uint64_t, graph::EdgeId> TransportRouter::GetRideEdgesByEnds() const {
+			std::unordered_map<uint64_t, graph::EdgeId> output;
+			for (graph::EdgeId edge_id = 0; edge_id < graph_.GetEdgeCount(); ++edge_id) {
+				if (!graph_.IsRemoved(edge_id) && edges_content_[edge_id].bus != EdgeContent::NO_BUS) {
+					output[GetEndsKey(graph_.GetEdge(edge_id))] = edge_id;
+				}
+			}
+			return output;
+		}
+
+		bool TransportRouter::SupportsBusUpdates() const {
+			switch (router_settings_.engine) {
+			case RouterEngine::CONTRACTION_HIERARCHY:
+			case RouterEngine::ALT:
+			case RouterEngine::HUB_LABELS:
+				return false;
+			default:
+				return true;
+			}
+		}
+
+		void TransportRouter::AddBusRoute(const domain::BusRoute* route) {
+			if (!SupportsBusUpdates()) {
+				throw std::logic_error("AddBusRoute: The routing engine doesn't take bus updates"s);
+			}
+			route_cache_.Clear();
+			if (router_settings_.engine == RouterEngine::RAPTOR) {
+				raptor_router_->AddBusRoute(route);
+				return;
+			}
+			if (FindBus(route) != EdgeContent::NO_BUS) {
+				throw std::invalid_argument("AddBusRoute: The bus is already added"s);
+			}
+			for (const domain::StopId stop : route->stops) {
+				if (bus_stop_to_vertex_.count(cat_.FindBusStop(stop)) == 0) {
+					throw std::invalid_argument("AddBusRoute: Unknown bus stop"s);
+				}
+			}
+
+			graph_.Thaw();
+			std::unordered_map<uint64_t, graph::EdgeId> ride_edge_by_ends = GetRideEdgesByEnds();
+			std::vector<graph::EdgeId> removed_edges;
+			std::vector<graph::EdgeId> added_edges;
+
+			const uint32_t bus = static_cast<uint32_t>(buses_.size());
+			buses_.push_back(route);
+			ForEachRideEdge(route, bus, [&](const graph::Edge<RouteWeight>& edge, const EdgeContent& content) {
+				if (edge.from == edge.to) {
+					return;
+				}
+				const uint64_t key = GetEndsKey(edge);
+				if (const auto it = ride_edge_by_ends.find(key); it != ride_edge_by_ends.end()) {
+					if (!PrefersRideEdge(edge.weight, bus, graph_.GetEdge(it->second).weight, edges_content_[it->second].bus)) {
+						return;
 					}
+					graph_.RemoveEdge(it->second);
+					removed_edges.push_back(it->second);
 				}
+				ride_edge_by_ends[key] = graph_.AddEdge(edge);
+				edges_content_.push_back(content);
+				added_edges.push_back(ride_edge_by_ends[key]);
+			});
+			graph_.Freeze();
+
+			RepairRouteBuilder(removed_edges, added_edges, route);
+		}
+
+		void TransportRouter::RemoveBusRoute(const domain::BusRoute* route) {
+			if (!SupportsBusUpdates()) {
+				throw std::logic_error("RemoveBusRoute: The routing engine doesn't take bus updates"s);
+			}
+			// The edges of the bus are found by its stops and distances, which the catalogue drops with the bus.
+			if (route == nullptr || cat_.FindBusRoute(route->id) != route) {
+				throw std::invalid_argument("RemoveBusRoute: The bus should still be in the catalogue"s);
+			}
+			const uint32_t removed_bus = router_settings_.engine == RouterEngine::RAPTOR ? EdgeContent::NO_BUS : FindBus(route);
+			if (router_settings_.engine != RouterEngine::RAPTOR && removed_bus == EdgeContent::NO_BUS) {
+				throw std::invalid_argument("RemoveBusRoute: Unknown bus"s);
 			}
-			router_ = std::make_unique<graph::Router<double>>(graph_);
+			route_cache_.Clear();
+			if (router_settings_.engine == RouterEngine::RAPTOR) {
+				raptor_router_->RemoveBusRoute(route);
+				return;
+			}
+
+			graph_.Thaw();
+			std::unordered_map<uint64_t, graph::EdgeId> ride_edge_by_ends = GetRideEdgesByEnds();
+			std::vector<graph::EdgeId> removed_edges;
+			std::unordered_map<uint64_t, size_t> lost_ends;
 
+			ForEachRideEdge(route, removed_bus, [&](const graph::Edge<RouteWeight>& edge, const EdgeContent&) {
+				const auto it = ride_edge_by_ends.find(GetEndsKey(edge));
+				if (it != ride_edge_by_ends.end() && edges_content_[it->second].bus == removed_bus) {
+					graph_.RemoveEdge(it->second);
+					removed_edges.push_back(it->second);
+					lost_ends.emplace(it->first, lost_ends.size());
+					ride_edge_by_ends.erase(it);
+				}
+			});
+
+			// The pairs of vertices the bus served may still be served by other buses
+			// whose edges were pruned: the one a rebuilt router would keep takes the place.
+			std::set<std::string_view, std::less<>> neighbour_buses;
+			for (const domain::StopId stop : route->stops) {
+				const auto& buses = cat_.GetInformationAboutStop(stop);
+				neighbour_buses.insert(buses.begin(), buses.end());
+			}
+			std::vector<std::optional<std::pair<graph::Edge<RouteWeight>, EdgeContent>>> replacements(lost_ends.size());
+			for (const auto& bus_name : neighbour_buses) {
+				const domain::BusRoute* bus = cat_.FindBusRoute(bus_name);
+				if (bus == route) {
+					continue;
+				}
+				ForEachRideEdge(bus, FindBus(bus), [&](const graph::Edge<RouteWeight>& edge, const EdgeContent& content) {
+					const auto it = lost_ends.find(GetEndsKey(edge));
+					if (it != lost_ends.end() && (!replacements[it->second]
+						|| PrefersRideEdge(edge.weight, content.bus, replacements[it->second]->first.weight, replacements[it->second]->second.bus))) {
+						replacements[it->second] = std::make_pair(edge, content);
+					}
+				});
+			}
+			buses_[removed_bus] = nullptr;
+			std::vector<graph::EdgeId> added_edges;
+			for (const auto& replacement : replacements) {
+				if (replacement) {
+					added_edges.push_back(graph_.AddEdge(replacement->first));
+					edges_content_.push_back(replacement->second);
+				}
+			}
+			graph_.Freeze();
+
+			RepairRouteBuilder(removed_edges, added_edges, nullptr);
+		}
+
+		// The searches keep referring to graph_, which is changed in place, and the stops and their
+		// vertices stay the same, so the reachability search needs nothing either.
+		void TransportRouter::RepairRouteBuilder(const std::vector<graph::EdgeId>& removed_edges, const std::vector<graph::EdgeId>& added_edges,
+												 const domain::BusRoute* added_route) {
+			switch (router_settings_.engine) {
+			case RouterEngine::PRECOMPUTED:
+				static_cast<graph::Router<RouteWeight>&>(*router_).UpdateRoutes(removed_edges, added_edges, router_settings_.precompute_threads);
+				break;
+			case RouterEngine::A_STAR:
+				// A removed bus can only raise the least ratio, so the bound stays below the real times.
+				if (added_route != nullptr && GetRoadToGeoRatio(*added_route) < geo_heuristic_ratio_) {
+					router_ = CreateRouteBuilder();
+				}
+				break;
+			default:
+				break;
+			}
+		}
+
+		void TransportRouter::InitializeReachability() {
+			if (router_settings_.engine == RouterEngine::RAPTOR) {
+				return;
+			}
+			interface_vertex_to_stop_.assign(graph_.GetVertexCount(), nullptr);
+			for (const auto& [stop, exchange] : bus_stop_to_vertex_) {
+				interface_vertex_to_stop_[exchange.interface_vertex] = stop;
+			}
+			reachability_router_ = std::make_unique<graph::DijkstraRouter<RouteWeight>>(graph_);
 		}
 
 		void TransportRouter::LoadRouterSettings(const RouterSettings& settings) {
 			router_settings_ = settings;
 		}
 
-		std::optional<std::pair<std::vector<router::RoutePart>, double>> TransportRouter::BuildFastestRoute(domain::BusStop* start, domain::BusStop* finish) {		
+		std::optional<std::pair<std::vector<router::RoutePart>, double>> TransportRouter::BuildFastestRoute(domain::BusStop* start, domain::BusStop* finish) {
 			std::vector<router::RoutePart> output;
+			const std::optional<double> total_time = BuildFastestRoute(start, finish, output);
+			if (!total_time.has_value()) {
+				return {};
+			}
+			return std::make_pair(std::move(output), *total_time);
+		}
+
+		std::optional<double> TransportRouter::BuildFastestRoute(const domain::BusStop* start, const domain::BusStop* finish, std::vector<RoutePart>& itinerary) {
+			if (route_cache_.GetCapacity() == 0) {
+				return FindFastestRoute(start, finish, itinerary);
+			}
+
+			std::optional<double> total_time;
+			const bool cached = route_cache_.Visit({ start, finish }, [&itinerary, &total_time](const FastestRoute& route) {
+				itinerary.clear();
+				if (route.has_value()) {
+					itinerary.assign(route->first.begin(), route->first.end());
+					total_time = route->second;
+				}
+			});
+			if (cached) {
+				return total_time;
+			}
+
+			total_time = FindFastestRoute(start, finish, itinerary);
+			route_cache_.Put({ start, finish }, total_time.has_value() ? FastestRoute(std::make_pair(itinerary, *total_time)) : FastestRoute());
+			return total_time;
+		}
+
+		cache::CacheStatistics TransportRouter::GetRouteCacheStatistics() const {
+			return route_cache_.GetStatistics();
+		}
+
+		std::optional<double> TransportRouter::FindFastestRoute(const domain::BusStop* start, const domain::BusStop* finish, std::vector<RoutePart>& itinerary) const {
+			itinerary.clear();
+
+			if (router_settings_.engine == RouterEngine::RAPTOR) {
+				auto journey = raptor_router_->BuildRoute(start, finish);
+				if (!journey.has_value()) {
+					return {};
+				}
+				for (const auto& leg : journey->legs) {
+					itinerary.push_back({ WaitOrBus::WAIT, "", leg.board_stop->name, router_settings_.bus_wait_time, 0, 0 });
+					itinerary.push_back({ WaitOrBus::BUS, leg.bus->name, "", 0, leg.bus_time, leg.span_count });
+				}
+				return journey->total_time;
+			}
 
 			if ((bus_stop_to_vertex_.count(finish) == 0) || (bus_stop_to_vertex_.count(start) == 0)) {
 				return {};
 			}
 
 			if (start == finish) {
-				return std::make_pair(output, 0);
+				return 0.0;
 			}
 
-			auto search_result = router_->BuildRoute(bus_stop_to_vertex_.at(start).interface_vertex, bus_stop_to_vertex_.at(finish).interface_vertex);
-
-			if (!search_result.has_value()) {
+			static thread_local std::vector<graph::EdgeId> edges;
+			if (!router_->BuildRoute(bus_stop_to_vertex_.at(start).interface_vertex, bus_stop_to_vertex_.at(finish).interface_vertex, edges).has_value()) {
 				return {};
 			}
-			output.reserve(search_result.value().edges.size());
 
-			for (auto it = search_result.value().edges.begin(); it != search_result.value().edges.end(); ++it) {
-				output.push_back(edges_content_[*it]);
+			// The total is summed up from the parts, so it is as exact as they are whatever the weight type.
+			double total_time = 0.0;
+			for (const graph::EdgeId edge_id : edges) {
+				const RoutePart part = GetRoutePart(edge_id);
+				if (router_settings_.fold_wait_edges && part.wait_or_bus == WaitOrBus::BUS) {
+					itinerary.push_back({ WaitOrBus::WAIT, "", part.stop_name, router_settings_.bus_wait_time, 0, 0 });
+					total_time += static_cast<double>(router_settings_.bus_wait_time);
+				}
+				itinerary.push_back(part);
+				total_time += static_cast<double>(part.wait_time) + part.bus_time;
 			}
 
-			return std::make_pair(output, search_result->weight);
+			return total_time;
 		}
 	
-		const graph::DirectedWeightedGraph<double>& TransportRouter::GetGraph() const {
+		std::optional<std::vector<std::pair<const domain::BusStop*, double>>> TransportRouter::FindReachableStops(const domain::BusStop* start, double max_time) const {
+
+			if (router_settings_.engine == RouterEngine::RAPTOR) {
+				return raptor_router_->FindReachableStops(start, max_time);
+			}
+
+			if (bus_stop_to_vertex_.count(start) == 0) {
+				return {};
+			}
+			// Nothing is reachable within a negative time, which as a fixed-point weight would wrap around to a huge one.
+			if (!(max_time >= 0.0)) {
+				return std::vector<std::pair<const domain::BusStop*, double>>{};
+			}
+
+			// Fixed-point weights round every edge by up to half a unit, so the search goes that much further
+			// and the exact times, summed up along the edges of the search tree, decide.
+			RouteWeight max_weight = ToRouteWeight(max_time);
+			if constexpr (std::is_integral_v<RouteWeight>) {
+				max_weight = graph::WeightTraits<RouteWeight>::Add(max_weight, static_cast<RouteWeight>(graph_.GetVertexCount() / 2 + 1));
+			}
+
+			std::vector<std::pair<const domain::BusStop*, double>> output;
+			std::unordered_map<graph::VertexId, double> times;
+			reachability_router_->ForEachReachable(bus_stop_to_vertex_.at(start).interface_vertex, max_weight,
+				[this, &output, &times, max_time](graph::VertexId vertex, RouteWeight, std::optional<graph::EdgeId> prev_edge) {
+					const double time = prev_edge.has_value() ? times.at(graph_.GetEdge(*prev_edge).from) + GetEdgeTime(*prev_edge) : 0.0;
+					times[vertex] = time;
+					if (const domain::BusStop* stop = interface_vertex_to_stop_[vertex]; stop != nullptr && time <= max_time) {
+						output.emplace_back(stop, time);
+					}
+				});
+			std::sort(output.begin(), output.end(), [](const auto& lhs, const auto& rhs) {
+				return std::tie(lhs.second, lhs.first->name) < std::tie(rhs.second, rhs.first->name);
+			});
+
+			return output;
+		}
+
+		const graph::DirectedWeightedGraph<RouteWeight>& TransportRouter::GetGraph() const {
 			return graph_;
 		}
 	
@@ -114,20 +578,52 @@ namespace catalogue_core {
 			return bus_stop_to_vertex_;
 		}
 	
-		const graph::Router<double>::RoutesInternalData& TransportRouter::GetRouterData() const {
-			return router_->GetRouteInternalData();
+		const graph::Router<RouteWeight>::RoutesInternalData* TransportRouter::GetRouterData() const {
+			if (router_settings_.engine != RouterEngine::PRECOMPUTED) {
+				return nullptr;
+			}
+			return &static_cast<const graph::Router<RouteWeight>&>(*router_).GetRouteInternalData();
 		}
 
-		const std::vector<RoutePart>& TransportRouter::GetEdgesContent() const {
+		const graph::ContractionHierarchy<RouteWeight>* TransportRouter::GetContractionHierarchy() const {
+			if (router_settings_.engine != RouterEngine::CONTRACTION_HIERARCHY) {
+				return nullptr;
+			}
+			return &static_cast<const graph::ContractionHierarchy<RouteWeight>&>(*router_);
+		}
+
+		const graph::Landmarks<RouteWeight>* TransportRouter::GetLandmarks() const {
+			if (router_settings_.engine != RouterEngine::ALT) {
+				return nullptr;
+			}
+			return landmarks_.get();
+		}
+
+		const graph::HubLabels<RouteWeight>* TransportRouter::GetHubLabels() const {
+			if (router_settings_.engine != RouterEngine::HUB_LABELS) {
+				return nullptr;
+			}
+			return &static_cast<const graph::HubLabels<RouteWeight>&>(*router_);
+		}
+
+		const std::vector<const domain::BusRoute*>& TransportRouter::GetBuses() const {
+			return buses_;
+		}
+
+		const std::vector<EdgeContent>& TransportRouter::GetEdgesContent() const {
 			return edges_content_;
 		}
 
-		const graph::DirectedWeightedGraph<double>& TransportRouter::GetGraphLink() const {
+		const graph::DirectedWeightedGraph<RouteWeight>& TransportRouter::GetGraphLink() const {
 			return graph_;
 		}
 
-		void TransportRouter::SetRouterLink(std::unique_ptr<graph::Router<double>>&& link) {
+		void TransportRouter::SetRouterLink(std::unique_ptr<graph::RouteBuilder<RouteWeight>>&& link) {
 			router_ = std::move(link);
 		}
+
+		void TransportRouter::SetLandmarks(std::unique_ptr<graph::Landmarks<RouteWeight>>&& landmarks) {
+			landmarks_ = std::move(landmarks);
+		}
 	}
 }
\ No newline at end of file
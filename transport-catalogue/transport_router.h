@@ -1,30 +1,82 @@
 #pragma once
 #include <string_view>
 #include <optional>
+#include <cstdint>
+#include <limits>
 //#include <utility>
 #include <memory>
 #include <vector>
 #include "graph.h"
 #include "router.h"
+#include "dijkstra_router.h"
+#include "a_star_router.h"
+#include "bidirectional_dijkstra_router.h"
+#include "contraction_hierarchy.h"
+#include "landmarks.h"
+#include "hub_labels.h"
+#include "raptor_router.h"
+#include "lru_cache.h"
 #include "transport_catalogue.h"
 
 namespace catalogue_core{
 	namespace router {
 
-		enum WaitOrBus {
+		enum WaitOrBus : uint8_t {
 			WAIT = 0,
 			BUS  = 1
 		};
 
+		enum RouterEngine {
+			PRECOMPUTED = 0,
+			DIJKSTRA = 1,
+			CONTRACTION_HIERARCHY = 2,
+			RAPTOR = 3,
+			A_STAR = 4,
+			BIDIRECTIONAL_DIJKSTRA = 5,
+			ALT = 6,
+			HUB_LABELS = 7
+		};
+
+		// Weight of the routing graph's edges: minutes by default, or whole centiseconds in uint32_t
+		// with TRANSPORT_ROUTER_FIXED_POINT_WEIGHTS, which are cheaper to add and compare during precompute.
+		// The weights only choose the route: its times are summed up again from the distances along the buses.
+#ifdef TRANSPORT_ROUTER_FIXED_POINT_WEIGHTS
+		using RouteWeight = uint32_t;
+		constexpr double ROUTE_WEIGHT_UNITS_PER_MINUTE = 6000.0;
+#else
+		using RouteWeight = double;
+		constexpr double ROUTE_WEIGHT_UNITS_PER_MINUTE = 1.0;
+#endif
+
+		RouteWeight ToRouteWeight(double minutes);
+		double ToMinutes(RouteWeight weight);
+
 		struct RouterSettings {
 
 			RouterSettings() = default;
 
 			int bus_wait_time = 0;
 			double bus_velocity = 0.0;
+			RouterEngine engine = RouterEngine::PRECOMPUTED;
+			// One vertex per stop with bus_wait_time added to every ride edge, instead of
+			// an interface and a bus vertex per stop joined by a wait edge.
+			bool fold_wait_edges = false;
+
+			bool parallel_precompute = false;
+			// Workers of the graph construction and the precomputes (0 - one per core).
+			size_t precompute_threads = 0;
+			bool report_progress = false;
+
+			// Fastest routes kept ready for repeated (start, finish) pairs; 0 disables the cache.
+			size_t route_cache_size = 0;
+
+			// Landmarks whose distance tables bound the A* search of the ALT engine.
+			size_t landmark_count = 8;
 
 		};
 
+		// With folded wait edges a ride part also keeps the stop where the bus is boarded,
+		// so the Wait item can be restored when a route is unpacked.
 		struct RoutePart {
 
 			WaitOrBus wait_or_bus;
@@ -35,6 +87,18 @@ namespace catalogue_core{
 			int span_count = 0;
 		};
 
+		// Packed payload of a graph edge: the bus (an index in TransportRouter::GetBuses, NO_BUS for a wait edge)
+		// and the positions in its stops where the ride starts and ends; a ride back along a non-circular bus
+		// has board_position > alight_position. The stop, the span and the exact ride time of a RoutePart
+		// follow from them, so the part is restored only when a route is unpacked.
+		struct EdgeContent {
+			static constexpr uint32_t NO_BUS = std::numeric_limits<uint32_t>::max();
+
+			uint32_t bus = NO_BUS;
+			uint32_t board_position = 0;
+			uint32_t alight_position = 0;
+		};
+
 		struct Exchange {
 			graph::VertexId interface_vertex;
 			graph::VertexId bus_vertex;
@@ -46,44 +110,127 @@ namespace catalogue_core{
 			
 			explicit TransportRouter(catalogue_core::transport_catalogue::TransportCatalogue& cat,
 										RouterSettings&& router_settings_,
-										graph::DirectedWeightedGraph<double>&& graph,
+										graph::DirectedWeightedGraph<RouteWeight>&& graph,
 										std::unordered_map<const domain::BusStop*, Exchange>&& bus_stop_to_vertex,
-										std::vector<RoutePart>&& edges_content)
+										std::vector<const domain::BusRoute*>&& buses,
+										std::vector<EdgeContent>&& edges_content)
 				: cat_(cat)
 				, router_settings_(std::move(router_settings_))
 				, graph_(std::move(graph))
 				, bus_stop_to_vertex_(std::move(bus_stop_to_vertex))
+				, buses_(std::move(buses))
 				, edges_content_(std::move(edges_content)) {
-
+				graph_.Freeze();
+				InitializeReachability();
 			}
 
 			void LoadRouterSettings(const RouterSettings& settings);
 			std::optional<std::pair<std::vector<router::RoutePart>, double>> BuildFastestRoute(domain::BusStop* start, domain::BusStop* finish);
 
+			// Writes the route into "itinerary", reusing its capacity, and returns the total time:
+			// once the buffer has grown, a query allocates nothing.
+			std::optional<double> BuildFastestRoute(const domain::BusStop* start, const domain::BusStop* finish, std::vector<RoutePart>& itinerary);
+
+			cache::CacheStatistics GetRouteCacheStatistics() const;
+
+			// The hierarchy, the landmarks and the hub labels can't be repaired locally, so their engines
+			// don't take bus updates.
+			bool SupportsBusUpdates() const;
+
+			// Adds or removes the ride edges of one bus and repairs only what depends on them: the affected rows
+			// of the precomputed table, the RAPTOR patterns of the bus or, for A*, the heuristic when the bus
+			// lowers its bound; Dijkstra searches read the graph as it is. An added bus must already be in
+			// the catalogue with known stops and refreshed distances (TransportCatalogue::SetAllRoutes),
+			// a removed one must stay there until the call returns. Cached routes are dropped.
+			// Both throw std::logic_error unless SupportsBusUpdates.
+			void AddBusRoute(const domain::BusRoute* route);
+			void RemoveBusRoute(const domain::BusRoute* route);
+
+			// Stops reachable from start within max_time minutes, with their travel times in ascending order;
+			// none for a negative max_time.
+			std::optional<std::vector<std::pair<const domain::BusStop*, double>>> FindReachableStops(const domain::BusStop* start, double max_time) const;
+
 			void TransferCreate(domain::BusStop* stop, graph::VertexId from);
 
-			const graph::DirectedWeightedGraph<double>& GetGraph() const;
+			const graph::DirectedWeightedGraph<RouteWeight>& GetGraph() const;
 
 			const RouterSettings& GetRouterSettings() const;
 
 			const std::unordered_map<const domain::BusStop*, Exchange>& GetBusstopToVertex() const;
 
-			const graph::Router<double>::RoutesInternalData& GetRouterData() const;
+			const graph::Router<RouteWeight>::RoutesInternalData* GetRouterData() const;
+
+			const graph::ContractionHierarchy<RouteWeight>* GetContractionHierarchy() const;
+
+			const graph::Landmarks<RouteWeight>* GetLandmarks() const;
+
+			const graph::HubLabels<RouteWeight>* GetHubLabels() const;
+
+			// Buses the edge contents refer to; a removed bus leaves nullptr in its place.
+			const std::vector<const domain::BusRoute*>& GetBuses() const;
 
-			const std::vector<RoutePart>& GetEdgesContent() const;
+			const std::vector<EdgeContent>& GetEdgesContent() const;
 
-			const graph::DirectedWeightedGraph<double>& GetGraphLink() const;
+			const graph::DirectedWeightedGraph<RouteWeight>& GetGraphLink() const;
 
-			void SetRouterLink(std::unique_ptr<graph::Router<double>>&& link);
+			void SetRouterLink(std::unique_ptr<graph::RouteBuilder<RouteWeight>>&& link);
+
+			void SetLandmarks(std::unique_ptr<graph::Landmarks<RouteWeight>>&& landmarks);
+
+			void CreateRaptorRouter();
+
+			// Remembers the road/geo ratio it scales by, so that an added bus replaces it only when lowering the ratio.
+			graph::AStarRouter<RouteWeight>::Heuristic CreateGeoHeuristic();
+			graph::AStarRouter<RouteWeight>::Heuristic CreateLandmarkHeuristic() const;
 
 		private:
+			using FastestRoute = std::optional<std::pair<std::vector<router::RoutePart>, double>>;
+			using StopPair = std::pair<const domain::BusStop*, const domain::BusStop*>;
+
+			struct StopPairHasher {
+				size_t operator()(const StopPair& stops) const {
+					return std::hash<const void*>{}(stops.first) * 37 + std::hash<const void*>{}(stops.second);
+				}
+			};
+
+			std::unique_ptr<graph::RouteBuilder<RouteWeight>> CreateRouteBuilder();
+			std::optional<double> FindFastestRoute(const domain::BusStop* start, const domain::BusStop* finish, std::vector<RoutePart>& itinerary) const;
+
+			// Calls callback(edge, content) for every ride edge of the bus with the given index, prunable ones included.
+			template <typename Callback>
+			void ForEachRideEdge(const domain::BusRoute* route, uint32_t bus, Callback&& callback) const;
+			// Whether a ride edge of the bus takes the place of a kept one with the same ends.
+			bool PrefersRideEdge(RouteWeight weight, uint32_t bus, RouteWeight kept_weight, uint32_t kept_bus) const;
+			uint32_t FindBus(const domain::BusRoute* route) const;
+			RoutePart GetRoutePart(graph::EdgeId edge_id) const;
+			// Minutes spent on the edge: waiting, riding or, with folded wait edges, both.
+			double GetEdgeTime(graph::EdgeId edge_id) const;
+			double GetRideTime(const domain::RouteDistances& distances, uint32_t board_position, uint32_t alight_position) const;
+			uint64_t GetEndsKey(const graph::Edge<RouteWeight>& edge) const;
+			std::unordered_map<uint64_t, graph::EdgeId> GetRideEdgesByEnds() const;
+			// The least road/geo length ratio over the ride segments of the bus, at most 1.
+			double GetRoadToGeoRatio(const domain::BusRoute& route) const;
+			// added_route is the bus that was added, nullptr after a removal.
+			void RepairRouteBuilder(const std::vector<graph::EdgeId>& removed_edges, const std::vector<graph::EdgeId>& added_edges,
+									const domain::BusRoute* added_route);
+			void InitializeReachability();
+
 			catalogue_core::transport_catalogue::TransportCatalogue& cat_;
 			RouterSettings router_settings_;
-			graph::DirectedWeightedGraph<double> graph_;
-			std::unique_ptr<graph::Router<double>> router_ = nullptr;
+			graph::DirectedWeightedGraph<RouteWeight> graph_;
+			std::unique_ptr<graph::RouteBuilder<RouteWeight>> router_ = nullptr;
+			std::unique_ptr<RaptorRouter> raptor_router_ = nullptr;
+			std::shared_ptr<const graph::Landmarks<RouteWeight>> landmarks_ = nullptr;
+			double geo_heuristic_ratio_ = 1.0;
 
 			std::unordered_map<const domain::BusStop*, Exchange> bus_stop_to_vertex_;
-			std::vector<RoutePart> edges_content_;
+			std::vector<const domain::BusRoute*> buses_;
+			std::vector<EdgeContent> edges_content_;
+
+			std::unique_ptr<graph::DijkstraRouter<RouteWeight>> reachability_router_ = nullptr;
+			std::vector<const domain::BusStop*> interface_vertex_to_stop_;
+
+			cache::LruCache<StopPair, FastestRoute, StopPairHasher> route_cache_{ router_settings_.route_cache_size };
 		};
 
 	}
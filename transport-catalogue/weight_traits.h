@@ -0,0 +1,34 @@
+#pragma once
+
+#include <limits>
+#include <type_traits>
+
+namespace graph {
+
+// Compile-time operations the searches need from an edge weight type.
+// Floating-point weights use a real infinity; unsigned integral weights (fixed-point times)
+// reserve their maximum for it and add with saturation, so "infinity plus anything" stays infinite.
+template <typename Weight, typename = void>
+struct WeightTraits;
+
+template <typename Weight>
+struct WeightTraits<Weight, std::enable_if_t<std::is_floating_point_v<Weight>>> {
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr Weight INFINITE_WEIGHT = std::numeric_limits<Weight>::infinity();
+
+    static constexpr Weight Add(Weight lhs, Weight rhs) {
+        return lhs + rhs;
+    }
+};
+
+template <typename Weight>
+struct WeightTraits<Weight, std::enable_if_t<std::is_integral_v<Weight> && std::is_unsigned_v<Weight>>> {
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr Weight INFINITE_WEIGHT = std::numeric_limits<Weight>::max();
+
+    static constexpr Weight Add(Weight lhs, Weight rhs) {
+        return rhs > INFINITE_WEIGHT - lhs ? INFINITE_WEIGHT : static_cast<Weight>(lhs + rhs);
+    }
+};
+
+}  // namespace graph